@@ -1,157 +1,1165 @@
-/**
- * @file    ADC.c
- *
- * @brief Implementation of ADC module for potentiometer input.
- *
- * This file initializes the ADC1 peripheral and provides functionality to perform
- * interrupt-based conversions using software triggering. The results are stored
- * in a circular buffer and averaged over the last 5 samples, providing stable
- * readings for temperature simulation.
- *
- * Used in the Real-Time System to read potentiometer values representing
- * simulated temperature, with data processing done in dedicated threads
- * rather than interrupt context to maintain system responsiveness.
- *
- * @par
- * Rodriguez Padilla, Daniel Jiram
- * IE703331
- * Martin del Campo, Mauricio
- * IE734429
- */
-
-#include "ADC.h"
-
-/* ================= Module state ================= */
-
-/* Active channel (configurable) */
-static volatile uint32_t s_activeChannel = ADC16_DEFAULT_CHANNEL;
-
-/* 20 ms scheduler reference (driven by caller's tick_ms) */
-static uint32_t s_lastKickMs = 0;
-
-/* Rolling buffer (5 samples) for integer °C */
-static uint8_t  s_tempBuf[ADC_AVG_WINDOW] = {0};
-static uint8_t  s_tempCount = 0;   /* Valid samples (<=5) */
-static uint8_t  s_tempIndex = 0;   /* Circular idx [0..4] */
-
-/* Last converted temperature (integer °C) */
-static uint8_t  s_lastTempC = 0;
-
-/* ASCII output buffer "dd.d" */
-uint8_t gAdcTempAscii[4] = { '0','0','.', '0' };
-
-/* ================= Internal helpers ================= */
-
-/* Integer mapping: raw counts (0..4095) -> °C (0..40). */
-static inline uint8_t ADC_CountsToTempC(uint16_t counts){
-    uint32_t t = ((uint32_t)counts * (uint32_t)TEMP_MAX_C) / (uint32_t)ADC_FULL_SCALE_COUNTS;
-    if (t > TEMP_MAX_C) t = TEMP_MAX_C;
-    return (uint8_t)t;
-}
-
-/* Push one temperature sample into rolling buffer (size 5). */
-static inline void ADC_PushTemp(uint8_t temp_c){
-    s_tempBuf[s_tempIndex] = temp_c;
-    s_tempIndex = (uint8_t)((s_tempIndex + 1U) % ADC_AVG_WINDOW);
-    if (s_tempCount < ADC_AVG_WINDOW){
-        s_tempCount++;
-    }
-}
-
-/* Do ONE blocking conversion on s_activeChannel (POLLING). */
-static uint16_t ADC_ConvertOnce_Polling(void){
-    adc16_channel_config_t ch = {0};
-    ch.channelNumber = s_activeChannel;
-    ch.enableInterruptOnConversionCompleted = false;  /* polling, no IRQ */
-#if defined(FSL_FEATURE_ADC16_HAS_DIFF_MODE) && FSL_FEATURE_ADC16_HAS_DIFF_MODE
-    ch.enableDifferentialConversion = false;
-#endif
-
-    /* Writing the channel config in software-trigger mode starts the conversion */
-    ADC16_SetChannelConfig(ADC16_BASE, ADC16_CHANNEL_GROUP, &ch);
-
-    /* Busy-wait until conversion completes (poll status flag) */
-    while (!(kADC16_ChannelConversionDoneFlag &
-             ADC16_GetChannelStatusFlags(ADC16_BASE, ADC16_CHANNEL_GROUP)))
-    {
-        /* INTENTIONALLY EMPTY: this is the polling loop by spec */
-    }
-
-    /* Read result and return */
-    return ADC16_GetChannelConversionValue(ADC16_BASE, ADC16_CHANNEL_GROUP);
-}
-
-/* ================= Public API ================= */
-
-void ADC_InitModule(void){
-    adc16_config_t cfg;
-    ADC16_GetDefaultConfig(&cfg);
-
-    /* Initialize and ensure software trigger mode (no hardware trigger) */
-    ADC16_Init(ADC16_BASE, &cfg);
-    ADC16_EnableHardwareTrigger(ADC16_BASE, false);
-
-    /* Optional accuracy features (enable if desired)
-     * ADC16_SetHardwareAverage(ADC16_BASE, kADC16_HardwareAverageCount4);
-     */
-
-    /* Reset module state */
-    s_activeChannel = ADC16_DEFAULT_CHANNEL;
-    s_lastKickMs    = 0U;
-    s_tempIndex     = 0U;
-    s_tempCount     = 0U;
-    s_lastTempC     = 0U;
-
-    /* No NVIC setup: we DO NOT use ADC interrupts in polling mode */
-}
-
-void ADC_SetChannel(uint32_t channel){
-    s_activeChannel = channel;
-}
-
-/* Periodic service:
- * - Caller supplies current tick in ms (monotonic).
- * - If 20 ms elapsed, perform ONE blocking conversion (polling).
- * - Convert to °C and push into rolling buffer.
- */
-void ADC_Service(uint32_t tick_ms){
-    if ((uint32_t)(tick_ms - s_lastKickMs) >= (uint32_t)ADC_SAMPLE_PERIOD_MS){
-        s_lastKickMs = tick_ms;
-
-        /* Do a single blocking conversion by POLLING */
-        uint16_t counts = ADC_ConvertOnce_Polling();
-
-        /* Post-process entirely outside any ISR (sequential execution) */
-        s_lastTempC = ADC_CountsToTempC(counts);
-        ADC_PushTemp(s_lastTempC);
-    }
-}
-
-uint8_t ADC_GetLastTempC(void){
-    return s_lastTempC;
-}
-
-uint8_t ADC_GetAvgTempC(void){
-    if (s_tempCount == 0U) return 0U;
-
-    uint16_t acc = 0U;
-    for (uint8_t i = 0U; i < s_tempCount; i++){
-        acc += s_tempBuf[i];
-    }
-    return (uint8_t)(acc / (uint16_t)s_tempCount);
-}
-
-/* Format integer temperature to "dd.d" ASCII ("fixed .0"). */
-void ADC_FormatTempToAscii(uint8_t temp_c){
-    uint8_t tens  = (uint8_t)(temp_c / 10U);
-    uint8_t units = (uint8_t)(temp_c % 10U);
-
-    gAdcTempAscii[0] = (uint8_t)(ASCII_ZERO + tens);
-    gAdcTempAscii[1] = (uint8_t)(ASCII_ZERO + units);
-    gAdcTempAscii[2] = (uint8_t)ASCII_DOT_CHAR;
-    gAdcTempAscii[3] = (uint8_t)(ASCII_ZERO + 0U); /* ".0" fixed */
-}
-
-void ADC_FormatAvgTempToAscii(void){
-    ADC_FormatTempToAscii(ADC_GetAvgTempC());
-}
+/**
+ * @file    ADC.c
+ *
+ * @brief Implementation of ADC module for potentiometer input.
+ *
+ * This file initializes the ADC1 peripheral and provides functionality to perform
+ * interrupt-based conversions using software triggering. The results are stored
+ * in a circular buffer and averaged over the last ADC_AVG_WINDOW samples, providing stable
+ * readings for temperature simulation.
+ *
+ * Used in the Real-Time System to read potentiometer values representing
+ * simulated temperature, with data processing done in dedicated threads
+ * rather than interrupt context to maintain system responsiveness.
+ *
+ * @par
+ * Rodriguez Padilla, Daniel Jiram
+ * IE703331
+ * Martin del Campo, Mauricio
+ * IE734429
+ */
+
+#include "ADC.h"
+#include "NVIC.h"
+#include <string.h>
+#if ADC_USE_IRQ
+#include "SPSC.h"
+#endif
+#if ADC_CALIBRATION
+#include "fsl_flash.h"
+#include <stddef.h>
+#endif
+#if ADC_USE_DMA
+#include "fsl_pdb.h"
+#include "fsl_edma.h"
+#include "fsl_dmamux.h"
+#endif
+
+#if ADC_USE_IRQ && ADC_USE_DMA
+#error "ADC_USE_IRQ and ADC_USE_DMA are mutually exclusive"
+#endif
+
+#if (ADC_MEDIAN_WINDOW > ADC_AVG_WINDOW) || ((ADC_MEDIAN_WINDOW & 1U) == 0U)
+#error "ADC_MEDIAN_WINDOW must be odd and not larger than ADC_AVG_WINDOW"
+#endif
+
+/* Next rolling-buffer index: a mask for power-of-two windows, a compare otherwise */
+#if ((ADC_AVG_WINDOW & (ADC_AVG_WINDOW - 1U)) == 0U)
+#define ADC_WINDOW_NEXT(i)      (((i) + 1U) & (ADC_AVG_WINDOW - 1U))
+#else
+#define ADC_WINDOW_NEXT(i)      ((((i) + 1U) == ADC_AVG_WINDOW) ? 0U : ((i) + 1U))
+#endif
+#define ADC_WINDOW_PREV(i)      (((i) == 0U) ? (ADC_AVG_WINDOW - 1U) : ((i) - 1U))
+
+/* ================= Module state ================= */
+
+/* Active channel (configurable) */
+static volatile uint32_t s_activeChannel = ADC16_DEFAULT_CHANNEL;
+
+/* 20 ms scheduler reference (driven by caller's tick_ms) */
+static uint32_t s_lastKickMs = 0;
+
+/* Per-channel history: rolling buffer (ADC_AVG_WINDOW samples) in tenths of °C */
+typedef struct {
+    uint16_t buf[ADC_AVG_WINDOW];
+    uint16_t count;     /* Valid samples (<=ADC_AVG_WINDOW) */
+    uint16_t index;     /* Circular idx [0..ADC_AVG_WINDOW-1] */
+    uint32_t sum;       /* Sum of the valid samples */
+    int32_t  emaQ8;     /* EMA state, tenths of °C in Q8 */
+    uint16_t last;      /* Last converted temperature (tenths of °C) */
+} adc_chan_state_t;
+
+/* Slot 0 serves the single-channel API; slots 0..N-1 serve the scan list */
+static adc_chan_state_t s_chan[ADC_SCAN_MAX_CHANNELS];
+
+static adc_filter_t s_filter = ADC_FILTER_MEAN;
+
+/* Scan list, split per converter so ADC0 and ADC1 convert in parallel */
+static adc_scan_entry_t s_scanList[ADC_SCAN_MAX_CHANNELS];
+static uint8_t  s_scanSlots[2][ADC_SCAN_MAX_CHANNELS];
+static uint8_t  s_scanSlotCount[2] = { 0U, 0U };
+static uint32_t s_scanLastKickMs = 0;
+static bool     s_adc0Ready = false;
+
+/* Requested ADC1 settings; s_convDirty until they are written to the converter */
+static adc_conv_config_t s_conv;
+static volatile bool     s_convDirty = false;
+
+/* Left shift that brings an ADC1 result to 12 bits (negative: right shift) */
+static volatile int8_t   s_countShift = 0;
+
+#if !ADC_USE_DMA
+/* Adaptive averaging: smallest slack reported in the current window of jobs */
+static bool     s_adaptive = false;
+static uint32_t s_adaptMinSlackUs = UINT32_MAX;
+static uint8_t  s_adaptJobs = 0U;
+
+/* Hardware averaging steps, fewest samples first */
+static const adc16_hardware_average_mode_t s_averageSteps[] = {
+    kADC16_HardwareAverageDisabled, kADC16_HardwareAverageCount4, kADC16_HardwareAverageCount8,
+    kADC16_HardwareAverageCount16, kADC16_HardwareAverageCount32
+};
+#define ADC_AVERAGE_STEPS   (sizeof(s_averageSteps) / sizeof(s_averageSteps[0]))
+#endif
+
+#if ADC_CALIBRATION
+/* Registers holding the calibration result of a converter, as stored in the flash record */
+static const uint8_t s_calRegOffsets[] = {
+    offsetof(ADC_Type, OFS),  offsetof(ADC_Type, PG),   offsetof(ADC_Type, MG),
+    offsetof(ADC_Type, CLPD), offsetof(ADC_Type, CLPS), offsetof(ADC_Type, CLP4),
+    offsetof(ADC_Type, CLP3), offsetof(ADC_Type, CLP2), offsetof(ADC_Type, CLP1),
+    offsetof(ADC_Type, CLP0), offsetof(ADC_Type, CLMD), offsetof(ADC_Type, CLMS),
+    offsetof(ADC_Type, CLM4), offsetof(ADC_Type, CLM3), offsetof(ADC_Type, CLM2),
+    offsetof(ADC_Type, CLM1), offsetof(ADC_Type, CLM0)
+};
+#define ADC_CAL_REGS    (sizeof(s_calRegOffsets) / sizeof(s_calRegOffsets[0]))
+
+typedef struct {
+    uint32_t magic;                 /* ADC_CAL_MAGIC */
+    uint32_t reg[2][ADC_CAL_REGS];  /* ADC0 then ADC1, in s_calRegOffsets order */
+    uint32_t crc;                   /* CRC-32 of every field above */
+} adc_cal_record_t;
+
+_Static_assert((sizeof(adc_cal_record_t) % FSL_FEATURE_FLASH_PFLASH_BLOCK_WRITE_UNIT_SIZE) == 0U,
+               "the calibration record must be a whole number of flash phrases");
+_Static_assert((ADC_CAL_FLASH_ADDR % FSL_FEATURE_FLASH_PFLASH_BLOCK_SECTOR_SIZE) == 0U,
+               "ADC_CAL_FLASH_ADDR must start a flash sector");
+#endif
+
+static adc_cal_state_t s_calState = ADC_CAL_NONE;
+
+#if ADC_USE_IRQ
+/* Conversion in flight, cleared by ADC1_IRQHandler */
+static volatile bool s_convBusy = false;
+
+/* Optional user notification on completion */
+static volatile adc_conv_callback_t s_convCallback = NULL;
+
+/* Raw results handed from ADC1_IRQHandler to ADC_Service() (ISR -> thread) */
+static uint16_t     s_irqSamples[ADC_IRQ_QUEUE_DEPTH];
+static spsc_queue_t s_irqQueue;
+#endif
+
+#if ADC_USE_DMA
+#define ADC_DMA_RING_BYTES  (ADC_DMA_RING_SAMPLES * sizeof(uint16_t))
+
+/* eDMA destination ring; aligned to its size so the destination modulo wraps it */
+static volatile uint16_t s_dmaRing[ADC_DMA_RING_SAMPLES] __attribute__((aligned(ADC_DMA_RING_BYTES)));
+
+/* Completed passes over the ring (major loops), counted by the eDMA interrupt */
+static volatile uint32_t s_dmaLaps = 0U;
+
+/* Samples consumed so far (free-running, wraps with the producer count) */
+static uint32_t s_dmaConsumed = 0U;
+static uint32_t s_dmaOverruns = 0U;
+#endif
+
+/* ASCII output buffer "dd.d" */
+uint8_t gAdcTempAscii[4] = { '0','0','.', '0' };
+
+/* ================= Internal helpers ================= */
+
+/* Fixed-point mapping: raw counts (0..4095) -> tenths of °C (0..400).
+ * One multiply by the precomputed Q16 scale and a shift, no divide. */
+static inline uint16_t ADC_CountsToTempDeci(uint16_t counts){
+    uint32_t t = ((uint32_t)counts * ADC_TEMP_DECI_SCALE_Q16) >> ADC_TEMP_SCALE_SHIFT;
+    if (t > TEMP_MAX_DECI) t = TEMP_MAX_DECI;
+    return (uint16_t)t;
+}
+
+/* Bring an ADC1 result from the configured resolution to the 12-bit scale. */
+static inline uint16_t ADC_NormalizeCounts(uint32_t counts){
+    int8_t shift = s_countShift;
+
+    return (uint16_t)((shift >= 0) ? (counts << shift) : (counts >> -shift));
+}
+
+/* Push one temperature sample into a channel's rolling buffer (size ADC_AVG_WINDOW).
+ * The sample leaving the window is subtracted from the running sum, so the
+ * mean never has to re-read the buffer. The EMA is advanced as well.
+ * Caller holds ADC_CEILING_STATE. */
+static inline void ADC_PushTempLocked(adc_chan_state_t *st, uint16_t temp_deci){
+    st->last = temp_deci;
+    if (st->count < ADC_AVG_WINDOW){
+        st->count++;
+        if (st->count == 1U){
+            st->emaQ8 = (int32_t)temp_deci << 8;   /* Seed the EMA with the first sample */
+        }
+    } else {
+        st->sum -= st->buf[st->index];
+    }
+    st->sum += temp_deci;
+    st->buf[st->index] = temp_deci;
+    st->index = (uint16_t)ADC_WINDOW_NEXT(st->index);
+
+    st->emaQ8 += (((int32_t)temp_deci << 8) - st->emaQ8) >> ADC_EMA_SHIFT;
+}
+
+static inline void ADC_PushTemp(adc_chan_state_t *st, uint16_t temp_deci){
+    nvic_critical_t crit = NVIC_enter_critical(ADC_CEILING_STATE);
+
+    ADC_PushTempLocked(st, temp_deci);
+    NVIC_exit_critical(crit);
+}
+
+#if ADC_SIMD
+_Static_assert(ADC_TEMP_SCALE_SHIFT == 16U, "the SIMD mapping takes the high half of each product");
+_Static_assert(ADC_TEMP_DECI_SCALE_Q16 <= 0x7FFFU, "the SIMD mapping multiplies by a signed halfword");
+#endif
+
+static inline bool ADC_WordAligned(const void *p){
+    return ((uintptr_t)p & 3U) == 0U;
+}
+
+/* Sum of n samples: two per SMLAD (each sample < 2^15, so the signed halves are exact). */
+static uint32_t ADC_SumTempDeci(const uint16_t *temp_deci, uint32_t n){
+    uint32_t sum = 0U;
+    uint32_t i = 0U;
+
+#if ADC_SIMD
+    if (ADC_WordAligned(temp_deci)){
+        const uint32_t *pair = (const uint32_t *)(const void *)temp_deci;
+
+        for (; (i + 2U) <= n; i += 2U){
+            sum = __SMLAD(*pair++, 0x00010001U, sum);
+        }
+    }
+#endif
+    for (; i < n; i++){
+        sum += temp_deci[i];
+    }
+    return sum;
+}
+
+/* Batch push, caller holds ADC_CEILING_STATE. */
+static void ADC_PushTempBlock(adc_chan_state_t *st, const uint16_t *temp_deci, uint32_t n){
+    uint32_t i = 0U;
+
+    if (n < ADC_AVG_WINDOW){
+        for (; i < n; i++){
+            ADC_PushTempLocked(st, temp_deci[i]);
+        }
+        return;
+    }
+
+    /* The EMA is a recurrence, so it still sees every sample */
+    if (st->count == 0U){
+        st->emaQ8 = (int32_t)temp_deci[0] << 8;
+        i = 1U;
+    }
+    for (; i < n; i++){
+        st->emaQ8 += (((int32_t)temp_deci[i] << 8) - st->emaQ8) >> ADC_EMA_SHIFT;
+    }
+
+    /* Only the newest ADC_AVG_WINDOW samples stay: oldest at buf[0], written next */
+    memcpy(st->buf, &temp_deci[n - ADC_AVG_WINDOW], sizeof(st->buf));
+    st->index = 0U;
+    st->count = ADC_AVG_WINDOW;
+    st->sum   = ADC_SumTempDeci(st->buf, ADC_AVG_WINDOW);
+    st->last  = temp_deci[n - 1U];
+}
+
+/* Median of the newest min(count, ADC_MEDIAN_WINDOW) samples (insertion sort on a copy). */
+static uint16_t ADC_MedianTemp(const adc_chan_state_t *st){
+    uint16_t sorted[ADC_MEDIAN_WINDOW];
+    uint16_t n = (st->count < ADC_MEDIAN_WINDOW) ? st->count : ADC_MEDIAN_WINDOW;
+    uint16_t idx = st->index;
+    uint16_t i, j;
+
+    for (i = 0U; i < n; i++){
+        uint16_t v;
+        idx = (uint16_t)ADC_WINDOW_PREV(idx);
+        v = st->buf[idx];
+        for (j = i; (j > 0U) && (sorted[j - 1U] > v); j--){
+            sorted[j] = sorted[j - 1U];
+        }
+        sorted[j] = v;
+    }
+    return sorted[n / 2U];
+}
+
+static uint16_t ADC_AvgTemp(const adc_chan_state_t *st){
+    nvic_critical_t crit = NVIC_enter_critical(ADC_CEILING_STATE);
+    uint16_t avg = (st->count == 0U) ? 0U : (uint16_t)(st->sum / st->count);
+
+    NVIC_exit_critical(crit);
+    return avg;
+}
+
+static uint16_t ADC_FilteredTemp(const adc_chan_state_t *st){
+    nvic_critical_t crit = NVIC_enter_critical(ADC_CEILING_STATE);
+    uint16_t temp;
+
+    if (st->count == 0U){
+        temp = 0U;
+    } else {
+        switch (s_filter){
+        case ADC_FILTER_EMA:
+            temp = (uint16_t)((st->emaQ8 + 0x80) >> 8);  /* Round Q8 to tenths of °C */
+            break;
+        case ADC_FILTER_MEDIAN:
+            temp = ADC_MedianTemp(st);
+            break;
+        case ADC_FILTER_MEAN:
+        default:
+            temp = ADC_AvgTemp(st);
+            break;
+        }
+    }
+    NVIC_exit_critical(crit);
+    return temp;
+}
+
+/* Start one software-triggered conversion (no IRQ) on the given converter. */
+static void ADC_StartOn(ADC_Type *base, uint32_t channel){
+    adc16_channel_config_t ch = {0};
+    ch.channelNumber = channel;
+    ch.enableInterruptOnConversionCompleted = false;
+#if defined(FSL_FEATURE_ADC16_HAS_DIFF_MODE) && FSL_FEATURE_ADC16_HAS_DIFF_MODE
+    ch.enableDifferentialConversion = false;
+#endif
+    ADC16_SetChannelConfig(base, ADC16_CHANNEL_GROUP, &ch);
+}
+
+#if !ADC_USE_IRQ && !ADC_USE_DMA
+/* Do ONE blocking conversion on s_activeChannel (POLLING). */
+static uint16_t ADC_ConvertOnce_Polling(void){
+    adc16_channel_config_t ch = {0};
+    ch.channelNumber = s_activeChannel;
+    ch.enableInterruptOnConversionCompleted = false;  /* polling, no IRQ */
+#if defined(FSL_FEATURE_ADC16_HAS_DIFF_MODE) && FSL_FEATURE_ADC16_HAS_DIFF_MODE
+    ch.enableDifferentialConversion = false;
+#endif
+
+    /* Writing the channel config in software-trigger mode starts the conversion */
+    ADC16_SetChannelConfig(ADC16_BASE, ADC16_CHANNEL_GROUP, &ch);
+
+    /* Busy-wait until conversion completes (poll status flag) */
+    while (!(kADC16_ChannelConversionDoneFlag &
+             ADC16_GetChannelStatusFlags(ADC16_BASE, ADC16_CHANNEL_GROUP)))
+    {
+        /* INTENTIONALLY EMPTY: this is the polling loop by spec */
+    }
+
+    /* Read result and return */
+    return ADC16_GetChannelConversionValue(ADC16_BASE, ADC16_CHANNEL_GROUP);
+}
+#endif /* !ADC_USE_IRQ && !ADC_USE_DMA */
+
+#if ADC_USE_IRQ
+/* Start ONE conversion on s_activeChannel and return; ADC1_IRQHandler completes it. */
+static void ADC_StartConversion_Irq(void){
+    adc16_channel_config_t ch = {0};
+    ch.channelNumber = s_activeChannel;
+    ch.enableInterruptOnConversionCompleted = true;
+#if defined(FSL_FEATURE_ADC16_HAS_DIFF_MODE) && FSL_FEATURE_ADC16_HAS_DIFF_MODE
+    ch.enableDifferentialConversion = false;
+#endif
+
+    s_convBusy = true;
+    ADC16_SetChannelConfig(ADC16_BASE, ADC16_CHANNEL_GROUP, &ch);
+}
+
+/* Conversion complete: reading the result clears COCO and the request.
+ * The sample is only queued here; ADC_Service() folds it into the filters, so the
+ * channel state is never written from interrupt context. */
+void ADC1_IRQHandler(void){
+    uint16_t counts = ADC_NormalizeCounts(ADC16_GetChannelConversionValue(ADC16_BASE, ADC16_CHANNEL_GROUP));
+    adc_conv_callback_t callback = s_convCallback;
+
+    (void)SPSC_Push(&s_irqQueue, &counts);
+    s_convBusy = false;
+
+    if (callback != NULL){
+        callback(ADC_CountsToTempDeci(counts));
+    }
+    __DSB();
+}
+#endif /* ADC_USE_IRQ */
+
+#if ADC_USE_DMA
+/* Major loop done: the destination already wrapped to the ring start, just count it. */
+void ADC_DMA_IRQ_HANDLER(void){
+    EDMA_ClearChannelStatusFlags(DMA0, ADC_DMA_CHANNEL, kEDMA_InterruptFlag);
+    s_dmaLaps++;
+    __DSB();
+}
+
+/* Total samples written by the eDMA so far (free-running). */
+static uint32_t ADC_DmaProduced(void){
+    uint32_t laps, daddr, pending;
+
+    /* DADDR wraps and INT is set by the same major-loop completion, before the ISR
+     * counts the lap: a set INT flag is a lap not yet in s_dmaLaps. Re-read if the
+     * ISR ran or the ring wrapped between the reads. */
+    do {
+        laps    = s_dmaLaps;
+        pending = (DMA0->INT >> ADC_DMA_CHANNEL) & 1U;
+        daddr   = DMA0->TCD[ADC_DMA_CHANNEL].DADDR;
+    } while ((laps != s_dmaLaps) || (pending != ((DMA0->INT >> ADC_DMA_CHANNEL) & 1U)));
+
+    return ((laps + pending) << ADC_DMA_RING_LOG2) +
+           ((daddr - (uint32_t)s_dmaRing) / sizeof(uint16_t));
+}
+
+/* PDB0 period for ADC_DMA_SAMPLE_HZ: smallest prescaler that fits the 16-bit modulus. */
+static void ADC_DmaInitPdb(void){
+    static const uint8_t mult[] = { 1U, 10U, 20U, 40U };
+    pdb_config_t pdbCfg;
+    pdb_adc_pretrigger_config_t preCfg = {0};
+    uint32_t busHz = CLOCK_GetFreq(kCLOCK_BusClk);
+    uint32_t counts = 0U;
+    uint8_t m, p = 0U;
+
+    PDB_GetDefaultConfig(&pdbCfg);
+    pdbCfg.enableContinuousMode = true;
+    pdbCfg.triggerInputSource   = kPDB_TriggerSoftware;
+
+    for (m = 0U; m < sizeof(mult); m++){
+        for (p = 0U; p < 8U; p++){
+            counts = busHz / ((uint32_t)mult[m] << p) / ADC_DMA_SAMPLE_HZ;
+            if (counts <= 0xFFFFU){ break; }
+        }
+        if (counts <= 0xFFFFU){ break; }
+    }
+    pdbCfg.prescalerDivider            = (pdb_prescaler_divider_t)p;
+    pdbCfg.dividerMultiplicationFactor = (pdb_divider_multiplication_factor_t)m;
+    PDB_Init(PDB0, &pdbCfg);
+
+    PDB_SetModulusValue(PDB0, counts - 1U);
+    PDB_SetCounterDelayValue(PDB0, 0U);
+
+    /* ADC1 is PDB channel 1; pre-trigger 0 drives conversion group A (SC1A) */
+    preCfg.enablePreTriggerMask = 1U << kPDB_ADCPreTrigger0;
+    preCfg.enableOutputMask     = 1U << kPDB_ADCPreTrigger0;
+    PDB_SetADCPreTriggerConfig(PDB0, kPDB_ADCTriggerChannel1, &preCfg);
+    PDB_SetADCPreTriggerDelayValue(PDB0, kPDB_ADCTriggerChannel1, kPDB_ADCPreTrigger0, 0U);
+    PDB_DoLoadValues(PDB0);
+}
+
+/* eDMA: one 16-bit transfer per ADC1 conversion, looping over s_dmaRing forever. */
+static void ADC_DmaInitEdma(void){
+    edma_config_t dmaCfg;
+    edma_transfer_config_t xfer;
+
+    DMAMUX_Init(DMAMUX0);
+    DMAMUX_SetSource(DMAMUX0, ADC_DMA_CHANNEL, kDmaRequestMux0ADC1);
+    DMAMUX_EnableChannel(DMAMUX0, ADC_DMA_CHANNEL);
+
+    EDMA_GetDefaultConfig(&dmaCfg);
+    EDMA_Init(DMA0, &dmaCfg);
+    EDMA_ResetChannel(DMA0, ADC_DMA_CHANNEL);
+
+    EDMA_PrepareTransfer(&xfer,
+                         (void *)&ADC16_BASE->R[ADC16_CHANNEL_GROUP], sizeof(uint16_t),
+                         (void *)s_dmaRing, sizeof(uint16_t),
+                         sizeof(uint16_t), ADC_DMA_RING_BYTES,
+                         kEDMA_PeripheralToMemory);
+    EDMA_SetTransferConfig(DMA0, ADC_DMA_CHANNEL, &xfer, NULL);
+
+    /* Destination wraps inside the ring; the request stays enabled after each major loop */
+    EDMA_SetModulo(DMA0, ADC_DMA_CHANNEL, kEDMA_ModuloDisable, (edma_modulo_t)(ADC_DMA_RING_LOG2 + 1U));
+    EDMA_EnableAutoStopRequest(DMA0, ADC_DMA_CHANNEL, false);
+    EDMA_EnableChannelInterrupts(DMA0, ADC_DMA_CHANNEL, kEDMA_MajorInterruptEnable);
+
+    /* ADC_DMA_IRQ itself is enabled by NVIC_init() */
+    EDMA_EnableChannelRequest(DMA0, ADC_DMA_CHANNEL);
+}
+
+/* Hardware trigger + DMA request on every conversion, then start PDB0. */
+static void ADC_DmaStart(void){
+    adc16_channel_config_t ch = {0};
+    ch.channelNumber = s_activeChannel;
+    ch.enableInterruptOnConversionCompleted = false;
+#if defined(FSL_FEATURE_ADC16_HAS_DIFF_MODE) && FSL_FEATURE_ADC16_HAS_DIFF_MODE
+    ch.enableDifferentialConversion = false;
+#endif
+
+    s_dmaLaps     = 0U;
+    s_dmaConsumed = 0U;
+    s_dmaOverruns = 0U;
+
+    ADC_DmaInitEdma();
+    ADC_DmaInitPdb();
+
+    ADC16_EnableDMA(ADC16_BASE, true);
+    ADC16_EnableHardwareTrigger(ADC16_BASE, true);
+    ADC16_SetChannelConfig(ADC16_BASE, ADC16_CHANNEL_GROUP, &ch);
+
+    PDB_DoSoftwareTrigger(PDB0);
+}
+#endif /* ADC_USE_DMA */
+
+/* ADCK frequency of `config`; ADACK is taken at its minimum so estimates stay on the safe side. */
+static uint32_t ADC_AdckHz(const adc_conv_config_t *config){
+    uint32_t hz;
+
+    switch (config->clockSource){
+    case kADC16_ClockSourceAlt0:
+        hz = CLOCK_GetFreq(kCLOCK_BusClk);
+        break;
+    case kADC16_ClockSourceAlt1:
+        hz = CLOCK_GetFreq(kCLOCK_BusClk) / 2U;
+        break;
+    case kADC16_ClockSourceAlt2:
+        hz = CLOCK_GetFreq(kCLOCK_Osc0ErClk);   /* ALTCLK = OSCERCLK */
+        break;
+    default:
+        hz = ADC_ADACK_MIN_HZ;
+        break;
+    }
+    return hz >> (uint32_t)config->clockDivider;
+}
+
+static bool ADC_ConfigInRange(const adc_conv_config_t *config){
+    return ((uint32_t)config->resolution   <= (uint32_t)kADC16_ResolutionSE16Bit) &&
+           ((uint32_t)config->average      <= (uint32_t)kADC16_HardwareAverageDisabled) &&
+           ((uint32_t)config->sampleTime   <= (uint32_t)kADC16_LongSampleDisabled) &&
+           ((uint32_t)config->clockSource  <= (uint32_t)kADC16_ClockSourceAsynchronousClock) &&
+           ((uint32_t)config->clockDivider <= (uint32_t)kADC16_ClockDivider8);
+}
+
+/* Write s_conv to ADC1. Software trigger, except under the PDB/eDMA pipeline. */
+static void ADC_ApplyConversionConfig(void){
+    static const int8_t shift[] = { 4, 0, 2, -4 };  /* By adc16_resolution_t: 8, 12, 10, 16 bit */
+    adc16_config_t cfg;
+    ADC16_GetDefaultConfig(&cfg);
+
+    cfg.resolution     = s_conv.resolution;
+    cfg.longSampleMode = s_conv.sampleTime;
+    cfg.clockSource    = s_conv.clockSource;
+    cfg.clockDivider   = s_conv.clockDivider;
+    cfg.enableAsynchronousClock = (s_conv.clockSource == kADC16_ClockSourceAsynchronousClock);
+    ADC16_Init(ADC16_BASE, &cfg);
+    ADC16_SetHardwareAverage(ADC16_BASE, s_conv.average);
+#if ADC_USE_DMA
+    ADC16_EnableDMA(ADC16_BASE, true);
+    ADC16_EnableHardwareTrigger(ADC16_BASE, true);
+#else
+    ADC16_EnableHardwareTrigger(ADC16_BASE, false);
+#endif
+
+    s_countShift = shift[s_conv.resolution];
+    s_convDirty  = false;
+}
+
+/* ADC0 is only brought up for the scan list or for calibration, ADC1 always is */
+static void ADC_Adc0Up(void){
+    adc16_config_t cfg;
+
+    if (s_adc0Ready){
+        return;
+    }
+    ADC16_GetDefaultConfig(&cfg);
+    ADC16_Init(ADC0, &cfg);
+    ADC16_EnableHardwareTrigger(ADC0, false);
+    s_adc0Ready = true;
+}
+
+#if ADC_CALIBRATION
+static ADC_Type *const s_calBase[2] = { ADC0, ADC16_BASE };
+
+static inline volatile uint32_t *ADC_CalRegister(uint32_t conv, uint32_t i){
+    return (volatile uint32_t *)((uintptr_t)s_calBase[conv] + s_calRegOffsets[i]);
+}
+
+/* CRC-32 (IEEE 802.3, reflected), bitwise: the record is checked once per boot. */
+static uint32_t ADC_Crc32(const void *data, uint32_t length){
+    const uint8_t *byte = (const uint8_t *)data;
+    uint32_t crc = 0xFFFFFFFFU;
+    uint32_t bit;
+
+    while (length-- != 0U){
+        crc ^= *byte++;
+        for (bit = 0U; bit < 8U; bit++){
+            crc = (crc >> 1) ^ (0xEDB88320U & (0U - (crc & 1U)));
+        }
+    }
+    return ~crc;
+}
+
+/* Load the constants from the flash record; false if it is erased or corrupt. */
+static bool ADC_CalLoad(void){
+    const adc_cal_record_t *rec = (const adc_cal_record_t *)ADC_CAL_FLASH_ADDR;
+    uint32_t conv, i;
+
+    if ((rec->magic != ADC_CAL_MAGIC) ||
+        (rec->crc != ADC_Crc32(rec, offsetof(adc_cal_record_t, crc)))){
+        return false;
+    }
+    ADC_Adc0Up();
+    for (conv = 0U; conv < 2U; conv++){
+        for (i = 0U; i < ADC_CAL_REGS; i++){
+            *ADC_CalRegister(conv, i) = rec->reg[conv][i];
+        }
+    }
+    return true;
+}
+
+/* Replace the flash record with the live constants and read it back. */
+static bool ADC_CalStore(void){
+    flash_config_t flash;
+    adc_cal_record_t rec;
+    uint32_t conv, i;
+
+    memset(&rec, 0, sizeof(rec));
+    rec.magic = ADC_CAL_MAGIC;
+    for (conv = 0U; conv < 2U; conv++){
+        for (i = 0U; i < ADC_CAL_REGS; i++){
+            rec.reg[conv][i] = *ADC_CalRegister(conv, i);
+        }
+    }
+    rec.crc = ADC_Crc32(&rec, offsetof(adc_cal_record_t, crc));
+
+    memset(&flash, 0, sizeof(flash));
+    if ((FLASH_Init(&flash) != kStatus_Success) ||
+        (FLASH_Erase(&flash, ADC_CAL_FLASH_ADDR, FSL_FEATURE_FLASH_PFLASH_BLOCK_SECTOR_SIZE,
+                     kFLASH_ApiEraseKey) != kStatus_Success) ||
+        (FLASH_Program(&flash, ADC_CAL_FLASH_ADDR, (void *)&rec, sizeof(rec)) != kStatus_Success)){
+        return false;
+    }
+    return memcmp((const void *)ADC_CAL_FLASH_ADDR, &rec, sizeof(rec)) == 0;
+}
+
+/* Auto-calibrate both converters under fixed reference conditions (driver-default
+ * clock, which stays below the 4 MHz calibration limit, and 32-sample averaging),
+ * then restore the active settings. The calibration registers survive ADC16_Init(). */
+static bool ADC_CalRun(void){
+    adc16_config_t cfg;
+    bool ok;
+    ADC16_GetDefaultConfig(&cfg);
+
+    ADC_Adc0Up();
+    ADC16_SetHardwareAverage(ADC0, kADC16_HardwareAverageCount32);
+    ok = (ADC16_DoAutoCalibration(ADC0) == kStatus_Success);
+    ADC16_SetHardwareAverage(ADC0, kADC16_HardwareAverageDisabled);
+
+    ADC16_Init(ADC16_BASE, &cfg);
+#if ADC_USE_DMA
+    ADC16_EnableDMA(ADC16_BASE, false);
+#endif
+    ADC16_EnableHardwareTrigger(ADC16_BASE, false);
+    ADC16_SetHardwareAverage(ADC16_BASE, kADC16_HardwareAverageCount32);
+    ok = (ADC16_DoAutoCalibration(ADC16_BASE) == kStatus_Success) && ok;
+
+    ADC_ApplyConversionConfig();
+    return ok;
+}
+#endif /* ADC_CALIBRATION */
+
+#if !ADC_USE_DMA
+static uint32_t ADC_AverageStep(adc16_hardware_average_mode_t average){
+    uint32_t step;
+
+    for (step = 0U; step < (ADC_AVERAGE_STEPS - 1U); step++){
+        if (s_averageSteps[step] == average){
+            break;
+        }
+    }
+    return step;
+}
+
+static void ADC_AdaptiveRestart(void){
+    s_adaptJobs       = 0U;
+    s_adaptMinSlackUs = UINT32_MAX;
+}
+#endif
+
+/* ================= Public API ================= */
+
+void ADC_InitModule(void){
+    adc16_config_t cfg;
+    ADC16_GetDefaultConfig(&cfg);
+
+    /* Driver defaults, no hardware averaging; see ADC_SetConversionConfig() */
+    s_conv.resolution   = cfg.resolution;
+    s_conv.average      = kADC16_HardwareAverageDisabled;
+    s_conv.sampleTime   = cfg.longSampleMode;
+    s_conv.clockSource  = cfg.clockSource;
+    s_conv.clockDivider = cfg.clockDivider;
+    ADC_ApplyConversionConfig();
+
+#if ADC_CALIBRATION
+    /* Cached constants normally; the calibration sequence only runs without a valid record */
+    if (ADC_CalLoad()){
+        s_calState = ADC_CAL_FLASH;
+    } else {
+        (void)ADC_Recalibrate();
+    }
+#endif
+
+    /* Reset module state */
+    s_activeChannel = ADC16_DEFAULT_CHANNEL;
+    s_lastKickMs    = 0U;
+    memset(s_chan, 0, sizeof(s_chan));
+    s_scanSlotCount[0] = 0U;
+    s_scanSlotCount[1] = 0U;
+#if !ADC_USE_DMA
+    ADC_AdaptiveRestart();
+#endif
+
+#if ADC_USE_IRQ
+    s_convBusy      = false;
+    (void)SPSC_Init(&s_irqQueue, s_irqSamples, ADC_IRQ_QUEUE_DEPTH, sizeof(s_irqSamples[0]));
+    /* ADC1_IRQ itself is enabled by NVIC_init() */
+#elif ADC_USE_DMA
+    ADC_DmaStart();
+#else
+    /* No NVIC setup: we DO NOT use ADC interrupts in polling mode */
+#endif
+}
+
+void ADC_SetChannel(uint32_t channel){
+    s_activeChannel = channel;
+}
+
+#if !ADC_USE_DMA
+void ADC_SetConversionTiming(adc16_clock_source_t source, adc16_clock_divider_t divider,
+                             adc16_hardware_average_mode_t average){
+    s_conv.clockSource  = source;
+    s_conv.clockDivider = divider;
+    s_conv.average      = average;
+    ADC_ApplyConversionConfig();
+}
+#endif
+
+bool ADC_SetConversionConfig(const adc_conv_config_t *config){
+    uint32_t maxHz, adckHz;
+
+    if (!ADC_ConfigInRange(config)){
+        return false;
+    }
+    maxHz  = (config->resolution == kADC16_ResolutionSE16Bit) ? ADC_ADCK_MAX_16BIT_HZ : ADC_ADCK_MAX_HZ;
+    adckHz = ADC_AdckHz(config);
+    if ((adckHz < ADC_ADCK_MIN_HZ) || (adckHz > maxHz)){
+        return false;
+    }
+#if ADC_USE_DMA
+    if (ADC_EstimateConversionUs(config) >= (1000000U / ADC_DMA_SAMPLE_HZ)){
+        return false;
+    }
+#endif
+
+    s_conv = *config;
+#if ADC_USE_IRQ
+    /* Rewriting ADC1 would abort a conversion in flight and leave s_convBusy set:
+     * ADC_Service() applies it before starting the next one */
+    s_convDirty = true;
+    if (!s_convBusy){
+        ADC_ApplyConversionConfig();
+    }
+#else
+    ADC_ApplyConversionConfig();
+#endif
+    return true;
+}
+
+void ADC_GetConversionConfig(adc_conv_config_t *config){
+    *config = s_conv;
+}
+
+uint32_t ADC_EstimateConversionUs(const adc_conv_config_t *config){
+    static const uint8_t baseCycles[]   = { 17U, 20U, 20U, 25U };    /* By resolution: 8, 12, 10, 16 bit */
+    static const uint8_t sampleCycles[] = { 20U, 12U, 6U, 2U, 0U };  /* By adc16_long_sample_mode_t */
+    static const uint8_t samples[]      = { 4U, 8U, 16U, 32U, 1U };  /* By adc16_hardware_average_mode_t */
+    uint32_t adckCycles, adckHz, busHz;
+    uint64_t ns;
+
+    if (!ADC_ConfigInRange(config)){
+        return UINT32_MAX;
+    }
+    adckHz = ADC_AdckHz(config);
+    busHz  = CLOCK_GetFreq(kCLOCK_BusClk);
+    if ((adckHz == 0U) || (busHz == 0U)){
+        return UINT32_MAX;
+    }
+
+    /* SFC adder (3 ADCK + 5 bus cycles), then every averaged sample */
+    adckCycles = 3U + (uint32_t)samples[config->average] *
+                 ((uint32_t)baseCycles[config->resolution] + sampleCycles[config->sampleTime]);
+    ns = (((uint64_t)adckCycles * 1000000000U) + adckHz - 1U) / adckHz +
+         ((5ULL * 1000000000U) + busHz - 1U) / busHz;
+    return (uint32_t)((ns + 999U) / 1000U);
+}
+
+bool ADC_Recalibrate(void){
+#if ADC_CALIBRATION
+#if ADC_USE_IRQ
+    if (s_convBusy){
+        return false;
+    }
+#endif
+    if (!ADC_CalRun()){
+        /* CALF: keep what the flash record had, if anything */
+        s_calState = ADC_CalLoad() ? ADC_CAL_FLASH : ADC_CAL_NONE;
+        return false;
+    }
+    s_calState = ADC_CalStore() ? ADC_CAL_NEW : ADC_CAL_UNSAVED;
+    return s_calState == ADC_CAL_NEW;
+#else
+    return false;
+#endif
+}
+
+adc_cal_state_t ADC_GetCalibrationState(void){
+    return s_calState;
+}
+
+void ADC_SetAdaptive(bool enable){
+#if !ADC_USE_DMA
+    s_adaptive = enable;
+    ADC_AdaptiveRestart();
+#else
+    (void)enable;
+#endif
+}
+
+void ADC_AdaptiveUpdate(uint32_t slackUs){
+#if !ADC_USE_DMA
+    adc_conv_config_t next = s_conv;
+    uint32_t step;
+
+    if (!s_adaptive){
+        return;
+    }
+    step = ADC_AverageStep(s_conv.average);
+
+    if (slackUs < ADC_ADAPT_MARGIN_US){
+        /* Under load: shed one averaging step right away */
+        if (step > 0U){
+            next.average = s_averageSteps[step - 1U];
+            (void)ADC_SetConversionConfig(&next);
+        }
+        ADC_AdaptiveRestart();
+        return;
+    }
+
+    if (slackUs < s_adaptMinSlackUs){
+        s_adaptMinSlackUs = slackUs;
+    }
+    if (++s_adaptJobs < ADC_ADAPT_RAISE_JOBS){
+        return;
+    }
+
+    /* The tightest job of the window must still fit the longer ADC1 conversions (one
+     * per job, or every ADC1 scan entry) and keep the margin */
+    if ((step + 1U) < ADC_AVERAGE_STEPS){
+        uint32_t conversions = (s_scanSlotCount[1] != 0U) ? s_scanSlotCount[1] : 1U;
+        uint32_t extraUs;
+
+        next.average = s_averageSteps[step + 1U];
+        extraUs = (ADC_EstimateConversionUs(&next) - ADC_EstimateConversionUs(&s_conv)) * conversions;
+        if (s_adaptMinSlackUs >= (extraUs + ADC_ADAPT_MARGIN_US)){
+            (void)ADC_SetConversionConfig(&next);
+        }
+    }
+    ADC_AdaptiveRestart();
+#else
+    (void)slackUs;
+#endif
+}
+
+#if !ADC_USE_IRQ && !ADC_USE_DMA
+uint16_t ADC_ConvertOnce(void){
+    return ADC_ConvertOnce_Polling();
+}
+#endif
+
+/* Periodic service:
+ * - Caller supplies current tick in ms (monotonic).
+ * - If 20 ms elapsed, perform ONE conversion (polling, or started for the IRQ).
+ * - Convert to °C and push into rolling buffer.
+ */
+void ADC_Service(uint32_t tick_ms){
+#if ADC_USE_DMA
+    /* Sampling is hardware-timed; just drain the ring, one block at a time */
+    uint16_t batch[16] __attribute__((aligned(4)));
+    uint32_t n, i;
+
+    (void)tick_ms;
+    while ((n = ADC_DmaReadSamples(batch, sizeof(batch) / sizeof(batch[0]))) != 0U){
+        if (s_countShift != 0){
+            for (i = 0U; i < n; i++){
+                batch[i] = ADC_NormalizeCounts(batch[i]);
+            }
+        }
+        ADC_CountsToTempDeciBatch(batch, batch, n);
+        ADC_PushTempBatch(0U, batch, n);
+    }
+#else
+#if ADC_USE_IRQ
+    uint16_t counts;
+
+    /* Fold in every result the ISR queued since the previous call */
+    while (SPSC_Pop(&s_irqQueue, &counts)){
+        ADC_PushTemp(&s_chan[0], ADC_CountsToTempDeci(counts));
+    }
+#endif
+    if ((uint32_t)(tick_ms - s_lastKickMs) >= (uint32_t)ADC_SAMPLE_PERIOD_MS){
+#if ADC_USE_IRQ
+        /* Previous conversion still running: retry on the next call */
+        if (!s_convBusy){
+            s_lastKickMs = tick_ms;
+            if (s_convDirty){
+                ADC_ApplyConversionConfig();
+            }
+            ADC_StartConversion_Irq();
+        }
+#else
+        s_lastKickMs = tick_ms;
+
+        /* Do a single blocking conversion by POLLING */
+        uint16_t counts = ADC_ConvertOnce_Polling();
+
+        /* Post-process entirely outside any ISR (sequential execution) */
+        ADC_PushTemp(&s_chan[0], ADC_CountsToTempDeci(ADC_NormalizeCounts(counts)));
+#endif
+    }
+#endif /* ADC_USE_DMA */
+}
+
+void ADC_SetConversionCallback(adc_conv_callback_t callback){
+#if ADC_USE_IRQ
+    s_convCallback = callback;
+#else
+    (void)callback;
+#endif
+}
+
+bool ADC_IsBusy(void){
+#if ADC_USE_IRQ
+    return s_convBusy;
+#else
+    return false;
+#endif
+}
+
+uint32_t ADC_DmaReadSamples(uint16_t *dst, uint32_t max){
+#if ADC_USE_DMA
+    uint32_t produced = ADC_DmaProduced();
+    uint32_t avail = produced - s_dmaConsumed;
+    uint32_t i;
+
+    /* Producer lapped the consumer: skip to the oldest sample still in the ring */
+    if (avail > ADC_DMA_RING_SAMPLES){
+        s_dmaOverruns += avail - ADC_DMA_RING_SAMPLES;
+        s_dmaConsumed  = produced - ADC_DMA_RING_SAMPLES;
+        avail          = ADC_DMA_RING_SAMPLES;
+    }
+    if (avail > max){
+        avail = max;
+    }
+
+    for (i = 0U; i < avail; i++){
+        dst[i] = s_dmaRing[(s_dmaConsumed + i) & (ADC_DMA_RING_SAMPLES - 1U)];
+    }
+    s_dmaConsumed += avail;
+    return avail;
+#else
+    (void)dst;
+    (void)max;
+    return 0U;
+#endif
+}
+
+uint32_t ADC_DmaGetOverruns(void){
+#if ADC_USE_DMA
+    return s_dmaOverruns;
+#else
+    return 0U;
+#endif
+}
+
+uint32_t ADC_IrqGetDrops(void){
+#if ADC_USE_IRQ
+    return SPSC_GetDrops(&s_irqQueue);
+#else
+    return 0U;
+#endif
+}
+
+void ADC_CountsToTempDeciBatch(const uint16_t *counts, uint16_t *temp_deci, uint32_t n){
+    uint32_t i = 0U;
+
+#if ADC_SIMD
+    if (ADC_WordAligned(counts) && ADC_WordAligned(temp_deci)){
+        const uint32_t *in = (const uint32_t *)(const void *)counts;
+        uint32_t *out = (uint32_t *)(void *)temp_deci;
+        const uint32_t limit = TEMP_MAX_DECI * 0x00010001U;
+
+        for (; (i + 2U) <= n; i += 2U){
+            uint32_t pair = *in++;
+            /* Bottom and top sample times the Q16 scale; scale in the bottom half only */
+            uint32_t lo = __SMUAD(pair, ADC_TEMP_DECI_SCALE_Q16);
+            uint32_t hi = __SMUADX(pair, ADC_TEMP_DECI_SCALE_Q16);
+            uint32_t temp = __PKHBT(lo >> ADC_TEMP_SCALE_SHIFT, hi, 0);
+
+            /* min(temp, limit) per half: UQSUB16 leaves max(temp - limit, 0) */
+            *out++ = temp - __UQSUB16(temp, limit);
+        }
+    }
+#endif
+    for (; i < n; i++){
+        temp_deci[i] = ADC_CountsToTempDeci(counts[i]);
+    }
+}
+
+void ADC_PushTempBatch(uint8_t slot, const uint16_t *temp_deci, uint32_t n){
+    nvic_critical_t crit;
+
+    if ((slot >= ADC_SCAN_MAX_CHANNELS) || (n == 0U)){
+        return;
+    }
+    crit = NVIC_enter_critical(ADC_CEILING_STATE);
+    ADC_PushTempBlock(&s_chan[slot], temp_deci, n);
+    NVIC_exit_critical(crit);
+}
+
+uint16_t ADC_MeanTempDeciBatch(const uint16_t *temp_deci, uint32_t n){
+    return (n == 0U) ? 0U : (uint16_t)(ADC_SumTempDeci(temp_deci, n) / n);
+}
+
+uint16_t ADC_GetLastTempDeciC(void){
+    return s_chan[0].last;
+}
+
+uint16_t ADC_GetAvgTempDeciC(void){
+    return ADC_AvgTemp(&s_chan[0]);
+}
+
+uint8_t ADC_GetLastTempC(void){
+    return (uint8_t)(ADC_GetLastTempDeciC() / 10U);
+}
+
+uint8_t ADC_GetAvgTempC(void){
+    return (uint8_t)(ADC_GetAvgTempDeciC() / 10U);
+}
+
+void ADC_SetFilter(adc_filter_t filter){
+    s_filter = filter;
+}
+
+uint16_t ADC_GetFilteredTempDeciC(void){
+    return ADC_FilteredTemp(&s_chan[0]);
+}
+
+uint8_t ADC_GetFilteredTempC(void){
+    return (uint8_t)(ADC_GetFilteredTempDeciC() / 10U);
+}
+
+bool ADC_ScanConfig(const adc_scan_entry_t *list, uint8_t count){
+    uint8_t i;
+
+    if ((count == 0U) || (count > ADC_SCAN_MAX_CHANNELS)){
+        return false;
+    }
+    for (i = 0U; i < count; i++){
+        if (list[i].converter > 1U){
+            return false;
+        }
+#if ADC_USE_DMA
+        /* ADC1 is owned by the PDB/eDMA pipeline */
+        if (list[i].converter == 1U){
+            return false;
+        }
+#endif
+    }
+
+    s_scanSlotCount[0] = 0U;
+    s_scanSlotCount[1] = 0U;
+    for (i = 0U; i < count; i++){
+        uint8_t conv = list[i].converter;
+
+        s_scanList[i] = list[i];
+        s_scanSlots[conv][s_scanSlotCount[conv]++] = i;
+        memset(&s_chan[i], 0, sizeof(s_chan[i]));
+    }
+
+    if (s_scanSlotCount[0] != 0U){
+        ADC_Adc0Up();
+    }
+    return true;
+}
+
+void ADC_ScanService(uint32_t tick_ms){
+    static ADC_Type *const base[2] = { ADC0, ADC1 };
+    uint8_t pos[2] = { 0U, 0U };
+    uint8_t conv;
+
+    if ((uint32_t)(tick_ms - s_scanLastKickMs) < (uint32_t)ADC_SAMPLE_PERIOD_MS){
+        return;
+    }
+    s_scanLastKickMs = tick_ms;
+
+    /* Each round starts the next entry on both converters, then collects both results,
+     * so a list split across ADC0/ADC1 takes about half the sequential time. */
+    while ((pos[0] < s_scanSlotCount[0]) || (pos[1] < s_scanSlotCount[1])){
+        for (conv = 0U; conv < 2U; conv++){
+            if (pos[conv] < s_scanSlotCount[conv]){
+                ADC_StartOn(base[conv], s_scanList[s_scanSlots[conv][pos[conv]]].channel);
+            }
+        }
+        for (conv = 0U; conv < 2U; conv++){
+            if (pos[conv] < s_scanSlotCount[conv]){
+                uint8_t slot = s_scanSlots[conv][pos[conv]];
+                uint16_t counts;
+
+                while (!(kADC16_ChannelConversionDoneFlag &
+                         ADC16_GetChannelStatusFlags(base[conv], ADC16_CHANNEL_GROUP)))
+                {
+                }
+                counts = (uint16_t)ADC16_GetChannelConversionValue(base[conv], ADC16_CHANNEL_GROUP);
+                if (conv == 1U){
+                    counts = ADC_NormalizeCounts(counts);   /* ADC0 keeps the 12-bit default */
+                }
+                ADC_PushTemp(&s_chan[slot], ADC_CountsToTempDeci(counts));
+                pos[conv]++;
+            }
+        }
+    }
+}
+
+uint16_t ADC_ScanGetLastTempDeciC(uint8_t slot){
+    return (slot < ADC_SCAN_MAX_CHANNELS) ? s_chan[slot].last : 0U;
+}
+
+uint16_t ADC_ScanGetAvgTempDeciC(uint8_t slot){
+    return (slot < ADC_SCAN_MAX_CHANNELS) ? ADC_AvgTemp(&s_chan[slot]) : 0U;
+}
+
+uint16_t ADC_ScanGetFilteredTempDeciC(uint8_t slot){
+    return (slot < ADC_SCAN_MAX_CHANNELS) ? ADC_FilteredTemp(&s_chan[slot]) : 0U;
+}
+
+uint8_t ADC_ScanGetLastTempC(uint8_t slot){
+    return (uint8_t)(ADC_ScanGetLastTempDeciC(slot) / 10U);
+}
+
+uint8_t ADC_ScanGetAvgTempC(uint8_t slot){
+    return (uint8_t)(ADC_ScanGetAvgTempDeciC(slot) / 10U);
+}
+
+uint8_t ADC_ScanGetFilteredTempC(uint8_t slot){
+    return (uint8_t)(ADC_ScanGetFilteredTempDeciC(slot) / 10U);
+}
+
+/* Format tenths of °C to "dd.d" ASCII (constant divisors compile to multiplies). */
+void ADC_FormatTempDeciToAscii(uint16_t temp_deci){
+    uint16_t whole = (uint16_t)(temp_deci / 10U);
+
+    if (whole > 99U) whole = 99U;   /* Two integer digits */
+
+    gAdcTempAscii[0] = (uint8_t)(ASCII_ZERO + (whole / 10U));
+    gAdcTempAscii[1] = (uint8_t)(ASCII_ZERO + (whole % 10U));
+    gAdcTempAscii[2] = (uint8_t)ASCII_DOT_CHAR;
+    gAdcTempAscii[3] = (uint8_t)(ASCII_ZERO + (temp_deci % 10U));
+}
+
+/* Format integer temperature to "dd.d" ASCII (".0" decimal). */
+void ADC_FormatTempToAscii(uint8_t temp_c){
+    ADC_FormatTempDeciToAscii((uint16_t)(temp_c * 10U));
+}
+
+void ADC_FormatAvgTempToAscii(void){
+    ADC_FormatTempDeciToAscii(ADC_GetAvgTempDeciC());
+}
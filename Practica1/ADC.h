@@ -1,76 +1,323 @@
-/**
- * @file    ADC.h
- *
- * @brief ADC module for reading potentiometer input in Real-Time System.
- *
- * This module configures and manages the ADC1 peripheral to sample analog values
- * from a potentiometer connected to the K64. It provides functions to initialize
- * the ADC, start conversions, and retrieve the average of the last 5 samples.
- *
- * The module uses interrupt-based conversion with a circular buffer to store
- * readings, allowing non-blocking operation suitable for real-time systems.
- * Typical usage includes reading simulated temperature values for monitoring.
- *
- * @par
- * Rodriguez Padilla, Daniel Jiram
- * IE703331
- * Martin del Campo, Mauricio
- * IE734429
- */
-
-#ifndef ADC_H_
-#define ADC_H_
-
-#include "fsl_adc16.h"
-#include <stdint.h>
-#include <stdbool.h>
-#include <string.h>
-
-/* -------- Hardware selection (adjust to your board) -------- */
-#define ADC16_BASE              ADC1
-#define ADC16_CHANNEL_GROUP     0U
-#define ADC16_DEFAULT_CHANNEL   0U   /* Set your potentiometer channel */
-
-/* -------- Scaling constants -------- */
-#define ADC_FULL_SCALE_COUNTS   4096U   /* 12-bit ADC */
-#define TEMP_MAX_C              40U     /* Map 0..4095 -> 0..40 °C (demo scaling) */
-
-/* -------- Sampling policy -------- */
-#define ADC_SAMPLE_PERIOD_MS    20U     /* One conversion every 20 ms */
-#define ADC_AVG_WINDOW          5U      /* Rolling average of last 5 samples */
-
-/* -------- ASCII helpers (moved from CONSOLE) -------- */
-#define ASCII_ZERO              48      /* '0' */
-#define ASCII_DOT_CHAR          '.'     /* '.' */
-
-/* Public ASCII buffer for temperature string "dd.d" (length 4). */
-extern uint8_t gAdcTempAscii[4];
-
-/* -------- Public API -------- */
-
-/* Initialize ADC in software-trigger mode (polling, no interrupts). */
-void ADC_InitModule(void);
-
-/* Optional: change ADC channel at runtime. */
-void ADC_SetChannel(uint32_t channel);
-
-/* Call this periodically from your thread (e.g., every 10 ms).
- * - Triggers a conversion strictly every 20 ms.
- * - Performs POLLING until conversion is done (no IRQ).
- * - Pushes the sample into a 5-point rolling average buffer.
- */
-void ADC_Service(uint32_t tick_ms);
-
-/* Last temperature in °C (integer 0..40). */
-uint8_t ADC_GetLastTempC(void);
-
-/* Rolling average of last up-to-5 samples (integer °C). */
-uint8_t ADC_GetAvgTempC(void);
-
-/* Format integer °C into gAdcTempAscii as "dd.d" (e.g., 23 -> '2','3','.','0'). */
-void ADC_FormatTempToAscii(uint8_t temp_c);
-
-/* Convenience: format the rolling average into gAdcTempAscii. */
-void ADC_FormatAvgTempToAscii(void);
-
-#endif /* ADC_H_ */
+/**
+ * @file    ADC.h
+ *
+ * @brief ADC module for reading potentiometer input in Real-Time System.
+ *
+ * This module configures and manages the ADC1 peripheral to sample analog values
+ * from a potentiometer connected to the K64. It provides functions to initialize
+ * the ADC, start conversions, and retrieve the average of the last ADC_AVG_WINDOW samples.
+ *
+ * The module uses interrupt-based conversion with a circular buffer to store
+ * readings, allowing non-blocking operation suitable for real-time systems.
+ * Typical usage includes reading simulated temperature values for monitoring.
+ *
+ * @par
+ * Rodriguez Padilla, Daniel Jiram
+ * IE703331
+ * Martin del Campo, Mauricio
+ * IE734429
+ */
+
+#ifndef ADC_H_
+#define ADC_H_
+
+#include "fsl_adc16.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+/* -------- Hardware selection (adjust to your board) -------- */
+#define ADC16_BASE              ADC1
+#define ADC16_CHANNEL_GROUP     0U
+#define ADC16_DEFAULT_CHANNEL   0U   /* Set your potentiometer channel */
+
+/* -------- Conversion mode -------- */
+/* 1 = interrupt-driven: ADC_Service() only starts the conversion and ADC1_IRQHandler
+ *     stores the result. 0 = blocking conversion polled inside ADC_Service(). */
+#ifndef ADC_USE_IRQ
+#define ADC_USE_IRQ             0
+#endif
+#define ADC_IRQ_PRIORITY        PRIORITY_3   /* Below the PIT0 scheduler tick */
+#define ADC_IRQ_QUEUE_DEPTH     8U           /* ISR -> ADC_Service() results; power of two */
+
+/* 1 = hardware-timed: PDB0 triggers ADC1 every 1/ADC_DMA_SAMPLE_HZ s and eDMA moves
+ *     each result into a circular buffer with no CPU work per sample. */
+#ifndef ADC_USE_DMA
+#define ADC_USE_DMA             0
+#endif
+#ifndef ADC_DMA_SAMPLE_HZ
+#define ADC_DMA_SAMPLE_HZ       1000U       /* >= 1 Hz with a 60 MHz bus clock */
+#endif
+#define ADC_DMA_CHANNEL         0U          /* eDMA channel (and DMAMUX slot) */
+#define ADC_DMA_IRQ             DMA_CH0_IRQ
+#define ADC_DMA_IRQ_HANDLER     DMA0_IRQHandler
+#define ADC_DMA_IRQ_PRIORITY    PRIORITY_2
+#define ADC_DMA_RING_LOG2       8U          /* 256 samples; must be a power of two */
+#define ADC_DMA_RING_SAMPLES    (1UL << ADC_DMA_RING_LOG2)
+
+/* -------- Calibration -------- */
+/* 1 = ADC_InitModule() reloads the ADC0 and ADC1 calibration constants (OFS, PG, MG,
+ *     CLPx, CLMx) from a CRC-checked record in flash, and only runs the multi-millisecond
+ *     auto-calibration when there is no valid record (first boot), storing the result.
+ * The record sector must be kept out of the linker script's text region. It sits in
+ * the second program flash block, so erasing it does not stall code running from
+ * block 0 (read-while-write between blocks). */
+#ifndef ADC_CALIBRATION
+#define ADC_CALIBRATION         1
+#endif
+#ifndef ADC_CAL_FLASH_ADDR
+#define ADC_CAL_FLASH_ADDR      0x000FF000U     /* Last 4 KB sector of the 1 MB flash */
+#endif
+#define ADC_CAL_MAGIC           0xADC2CA10UL    /* Record with both converters */
+
+/* BASEPRI ceiling of the per-channel filter state (see NVIC_enter_critical). Samples
+ * are pushed and read in thread context only, so it just holds off PendSV (thread
+ * preemption) and leaves every ISR running. */
+#define ADC_CEILING_STATE       PRIORITY_15
+
+/* -------- Conversion timing estimate (K64 reference manual, ADC16 conversion time) -------- */
+#define ADC_ADACK_MIN_HZ        3000000U    /* ADACK lower bound (ADHSC = 0): worst case */
+#define ADC_ADCK_MIN_HZ         1000000U    /* fADCK lower limit (ADLPC = 0) */
+#define ADC_ADCK_MAX_HZ         18000000U   /* fADCK limit up to 13-bit resolution */
+#define ADC_ADCK_MAX_16BIT_HZ   12000000U   /* fADCK limit at 16-bit resolution */
+
+/* -------- Adaptive hardware averaging (see ADC_AdaptiveUpdate) -------- */
+#ifndef ADC_ADAPT_MARGIN_US
+#define ADC_ADAPT_MARGIN_US     100U    /* Slack always kept free in the caller's budget */
+#endif
+#ifndef ADC_ADAPT_RAISE_JOBS
+#define ADC_ADAPT_RAISE_JOBS    8U      /* Jobs with spare slack before averaging goes up */
+#endif
+
+/* -------- Batch kernels -------- */
+/* 1 = the *Batch functions work on two samples per instruction with the Cortex-M4
+ *     SIMD instructions (SMUAD/SMUADX, PKHBT, UQSUB16, SMLAD); 0 = plain C, e.g. for a
+ *     baseline benchmark. Defaults to on wherever the core has the DSP extension. */
+#ifndef ADC_SIMD
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+#define ADC_SIMD                1
+#else
+#define ADC_SIMD                0
+#endif
+#endif
+
+/* -------- Multi-channel scan -------- */
+#ifndef ADC_SCAN_MAX_CHANNELS
+#define ADC_SCAN_MAX_CHANNELS   8U      /* Analog inputs per board */
+#endif
+
+/* -------- Scaling constants -------- */
+#define ADC_FULL_SCALE_COUNTS   4096U   /* 12-bit ADC */
+#define TEMP_MAX_C              40U     /* Map 0..4095 -> 0..40 °C (demo scaling) */
+#define TEMP_MAX_DECI           (TEMP_MAX_C * 10U)  /* Full scale in tenths of °C */
+
+/* Q16 scale: tenths of °C per count, so deci = (counts * scale) >> 16 (no divide).
+ * 400 * 65536 / 4096 = 6400 exactly for the demo scaling; rounded otherwise. */
+#define ADC_TEMP_SCALE_SHIFT    16U
+#define ADC_TEMP_DECI_SCALE_Q16 \
+    ((uint32_t)((((uint64_t)TEMP_MAX_DECI << ADC_TEMP_SCALE_SHIFT) + (ADC_FULL_SCALE_COUNTS / 2U)) \
+                / ADC_FULL_SCALE_COUNTS))
+
+/* -------- Sampling policy -------- */
+#define ADC_SAMPLE_PERIOD_MS    20U     /* One conversion every 20 ms */
+#ifndef ADC_AVG_WINDOW
+/* Rolling average of the last ADC_AVG_WINDOW samples; the index wraps by mask when it
+ * is a power of two, by compare otherwise */
+#define ADC_AVG_WINDOW          5U
+#endif
+#ifndef ADC_EMA_SHIFT
+#define ADC_EMA_SHIFT           2U      /* EMA weight of a new sample = 1 / 2^ADC_EMA_SHIFT */
+#endif
+#ifndef ADC_MEDIAN_WINDOW
+#define ADC_MEDIAN_WINDOW       5U      /* Median of the last N samples (odd, <= ADC_AVG_WINDOW) */
+#endif
+
+/* -------- ASCII helpers (moved from CONSOLE) -------- */
+#define ASCII_ZERO              48      /* '0' */
+#define ASCII_DOT_CHAR          '.'     /* '.' */
+
+/* Public ASCII buffer for temperature string "dd.d" (length 4). */
+extern uint8_t gAdcTempAscii[4];
+
+/* Output filter applied by ADC_GetFilteredTempC(). */
+typedef enum {
+    ADC_FILTER_MEAN = 0,    /* Rolling mean over ADC_AVG_WINDOW samples */
+    ADC_FILTER_EMA,         /* Exponential moving average, alpha = 1/2^ADC_EMA_SHIFT */
+    ADC_FILTER_MEDIAN       /* Median of the last ADC_MEDIAN_WINDOW samples */
+} adc_filter_t;
+
+/* ADC1 conversion settings. Results are scaled to the 12-bit range whatever the
+ * resolution, so the temperature mapping and filters do not change. */
+typedef struct {
+    adc16_resolution_t            resolution;
+    adc16_hardware_average_mode_t average;      /* Samples per result */
+    adc16_long_sample_mode_t      sampleTime;   /* kADC16_LongSampleDisabled = short sample */
+    adc16_clock_source_t          clockSource;
+    adc16_clock_divider_t         clockDivider;
+} adc_conv_config_t;
+
+/* Where the calibration in use (both converters) came from. */
+typedef enum {
+    ADC_CAL_NONE = 0,       /* Uncalibrated: ADC_CALIBRATION = 0 or calibration failed */
+    ADC_CAL_FLASH,          /* Constants reloaded from the flash record */
+    ADC_CAL_NEW,            /* Calibrated this boot and stored to flash */
+    ADC_CAL_UNSAVED         /* Calibrated this boot, but the flash write failed */
+} adc_cal_state_t;
+
+/* One scan-list entry: which converter and which input channel. */
+typedef struct {
+    uint8_t converter;      /* 0 = ADC0, 1 = ADC1 */
+    uint8_t channel;        /* ADC input channel number */
+} adc_scan_entry_t;
+
+/* Completion callback, invoked from ADC1_IRQHandler after a result has been stored.
+ * The argument is the new sample in tenths of °C. */
+typedef void (*adc_conv_callback_t)(uint16_t temp_deci);
+
+/* -------- Public API -------- */
+
+/* Initialize ADC in software-trigger mode (polling, or completion IRQ when ADC_USE_IRQ).
+ * The ADC/eDMA interrupt lines are enabled by NVIC_init() (see NVIC_config.h). */
+void ADC_InitModule(void);
+
+/* Optional: change ADC channel at runtime. */
+void ADC_SetChannel(uint32_t channel);
+
+/* Call this periodically from your thread (e.g., every 10 ms).
+ * - Triggers a conversion strictly every 20 ms.
+ * - Polling mode: waits until the conversion is done and pushes the sample.
+ * - IRQ mode: starts the conversion and returns; ADC1_IRQHandler queues the raw result
+ *   and the next call moves it into the buffer (thread context).
+ * - Samples go into a rolling average buffer of the last ADC_AVG_WINDOW samples.
+ */
+void ADC_Service(uint32_t tick_ms);
+
+/* Polling/IRQ modes: re-initialize ADC1 with the given conversion clock, divider and
+ * hardware averaging, other settings unchanged. Unchecked, so the benchmark can sweep
+ * every combination; use ADC_SetConversionConfig() otherwise. */
+void ADC_SetConversionTiming(adc16_clock_source_t source, adc16_clock_divider_t divider,
+                             adc16_hardware_average_mode_t average);
+
+/* Reconfigure ADC1 conversions. Returns false, leaving the settings unchanged, when a
+ * field is out of range, ADCK would be outside its datasheet limits (or stopped, as
+ * ALTCLK is with OSCERCLK gated), or (DMA mode) a conversion would not fit in one
+ * ADC_DMA_SAMPLE_HZ period. In IRQ mode a conversion in flight finishes with the old
+ * settings first. Filter state is kept; ADC_InitModule() restores the driver defaults. */
+bool ADC_SetConversionConfig(const adc_conv_config_t *config);
+
+/* Settings currently requested (applied, or pending behind an IRQ-mode conversion). */
+void ADC_GetConversionConfig(adc_conv_config_t *config);
+
+/* Worst-case time of one conversion with `config` (microseconds, rounded up): the
+ * SFC adder plus AverageNum x (base + long sample) ADCK cycles, ADACK at its minimum.
+ * UINT32_MAX for a field out of range or a stopped ADCK. */
+uint32_t ADC_EstimateConversionUs(const adc_conv_config_t *config);
+
+/* Run ADC0 and ADC1 auto-calibration now (driver-default clock, 32-sample averaging) and replace
+ * the flash record with the result; the active conversion settings are restored.
+ * Returns true once the new constants are stored. On a calibration failure the
+ * previous constants are reloaded. IRQ mode: false while a conversion is in flight. */
+bool ADC_Recalibrate(void);
+
+adc_cal_state_t ADC_GetCalibrationState(void);
+
+/* Polling/IRQ modes: adaptive hardware averaging, off by default. The calling thread
+ * reports the budget it left unused after every job with ADC_AdaptiveUpdate(): averaging
+ * drops one step as soon as the slack falls under ADC_ADAPT_MARGIN_US, and rises one
+ * step once ADC_ADAPT_RAISE_JOBS consecutive jobs all had room for the longer
+ * conversions plus the margin. Other settings stay as configured. */
+void ADC_SetAdaptive(bool enable);
+void ADC_AdaptiveUpdate(uint32_t slackUs);
+
+/* Polling mode: one blocking conversion on the active channel, raw counts. Not pushed
+ * into the filters; used to time the conversion itself (see BENCH.h). */
+uint16_t ADC_ConvertOnce(void);
+
+/* IRQ mode: register a callback run on every completed conversion (NULL to remove).
+ * It executes in interrupt context, so keep it short. */
+void ADC_SetConversionCallback(adc_conv_callback_t callback);
+
+/* IRQ mode: true while a conversion started by ADC_Service() is in flight. */
+bool ADC_IsBusy(void);
+
+/* DMA mode: copy up to `max` raw samples (counts) acquired since the previous call into
+ * dst, oldest first; returns the number copied. Call at least once per
+ * ADC_DMA_RING_SAMPLES sample periods, otherwise the oldest samples are dropped and
+ * counted in ADC_DmaGetOverruns(). In DMA mode ADC_Service() drains the ring the same
+ * way and pushes every sample into the rolling buffer. */
+uint32_t ADC_DmaReadSamples(uint16_t *dst, uint32_t max);
+
+/* DMA mode: number of samples lost because the ring was not drained in time. */
+uint32_t ADC_DmaGetOverruns(void);
+
+/* IRQ mode: results lost because ADC_Service() did not drain the ISR queue in time. */
+uint32_t ADC_IrqGetDrops(void);
+
+/* Samples are stored in tenths of °C (0..TEMP_MAX_DECI). The *DeciC getters return
+ * that resolution; the *TempC getters truncate it to integer °C. */
+
+/* Last temperature (tenths of °C 0..400 / integer °C 0..40). */
+uint16_t ADC_GetLastTempDeciC(void);
+uint8_t ADC_GetLastTempC(void);
+
+/* Rolling average of the last ADC_AVG_WINDOW samples (fewer until the buffer fills).
+ * O(1): kept as a running sum. */
+uint16_t ADC_GetAvgTempDeciC(void);
+uint8_t ADC_GetAvgTempC(void);
+
+/* Select the filter used by ADC_GetFilteredTemp*() (default ADC_FILTER_MEAN). */
+void ADC_SetFilter(adc_filter_t filter);
+
+/* Temperature through the selected filter. */
+uint16_t ADC_GetFilteredTempDeciC(void);
+uint8_t ADC_GetFilteredTempC(void);
+
+/* Format tenths of °C into gAdcTempAscii as "dd.d" (e.g., 237 -> '2','3','.','7'). */
+void ADC_FormatTempDeciToAscii(uint16_t temp_deci);
+
+/* Format integer °C into gAdcTempAscii as "dd.d" (e.g., 23 -> '2','3','.','0'). */
+void ADC_FormatTempToAscii(uint8_t temp_c);
+
+/* Convenience: format the rolling average (tenths of °C) into gAdcTempAscii. */
+void ADC_FormatAvgTempToAscii(void);
+
+/* -------- Batch API --------
+ * For samples that arrive in blocks (DMA ring, scan rounds, bursts). Arrays should be
+ * 4-byte aligned: the SIMD path handles two samples per word and falls back to one at
+ * a time otherwise. In and out may be the same array.
+ */
+
+/* Map 12-bit counts to tenths of °C, clamped to TEMP_MAX_DECI. */
+void ADC_CountsToTempDeciBatch(const uint16_t *counts, uint16_t *temp_deci, uint32_t n);
+
+/* Push n samples (tenths of °C, oldest first) into a slot's filters in one critical
+ * section, as if pushed one by one. A block of at least ADC_AVG_WINDOW samples
+ * refills the window directly; only the EMA still steps through every sample. */
+void ADC_PushTempBatch(uint8_t slot, const uint16_t *temp_deci, uint32_t n);
+
+/* Mean of a block of samples (tenths of °C), 0 for an empty block. */
+uint16_t ADC_MeanTempDeciBatch(const uint16_t *temp_deci, uint32_t n);
+
+/* -------- Multi-channel scan API --------
+ * Every scan-list entry (slot) owns its own rolling buffer, last value and filter
+ * state, so no history is lost between channels. Slot 0 shares its state with the
+ * single-channel API above; use either ADC_Service() or ADC_ScanService(), not both.
+ */
+
+/* Install a scan list of 1..ADC_SCAN_MAX_CHANNELS entries (copied). Slot i = list[i].
+ * Returns false on an invalid entry. ADC0 is initialized on first use. */
+bool ADC_ScanConfig(const adc_scan_entry_t *list, uint8_t count);
+
+/* Call periodically: every ADC_SAMPLE_PERIOD_MS converts the whole list, running the
+ * ADC0 and ADC1 entries in parallel (polling). */
+void ADC_ScanService(uint32_t tick_ms);
+
+/* Per-slot results (tenths of °C / integer °C). */
+uint16_t ADC_ScanGetLastTempDeciC(uint8_t slot);
+uint16_t ADC_ScanGetAvgTempDeciC(uint8_t slot);
+uint16_t ADC_ScanGetFilteredTempDeciC(uint8_t slot);
+uint8_t ADC_ScanGetLastTempC(uint8_t slot);
+uint8_t ADC_ScanGetAvgTempC(uint8_t slot);
+uint8_t ADC_ScanGetFilteredTempC(uint8_t slot);
+
+#endif /* ADC_H_ */
@@ -0,0 +1,378 @@
+/**
+ * @file    BENCH.c
+ *
+ * @brief Implementation of the on-target micro-benchmarks.
+ */
+
+#include "RMS.h"
+
+#if RMS_BENCH
+#include "BENCH.h"
+#include "ADC.h"
+#include "NVIC.h"
+#include "STACK.h"
+#include "fsl_common.h"
+#include <stdio.h>
+#include <string.h>
+
+#define BENCH_SYS_WRITE0        0x04U   /* Semihosting: print a NUL-terminated string */
+#define BENCH_LINE_CHARS        128U
+#define BENCH_READ_COST_SAMPLES 16U
+#define BENCH_GUARD_PROBES      8U
+
+volatile uint32_t BenchStamp[BENCH_STAMP_COUNT];
+
+static bench_result_t s_results[BENCH_MAX_RESULTS];
+static uint8_t  s_resultCount = 0U;
+static uint32_t s_readCost = 0U;    /* Cycles between two back-to-back DWT reads */
+
+/* ================= Result table ================= */
+
+/* New result row, or NULL once the table is full (the benchmark is then skipped) */
+static bench_result_t *BENCH_Open(const char *name){
+    bench_result_t *r;
+
+    if (s_resultCount >= BENCH_MAX_RESULTS){
+        return NULL;
+    }
+    r = &s_results[s_resultCount++];
+    memset(r, 0, sizeof(*r));
+    (void)strncpy(r->name, name, BENCH_NAME_CHARS - 1U);
+    r->min = UINT32_MAX;
+    return r;
+}
+
+static void BENCH_Add(bench_result_t *r, uint32_t cycles){
+    if (r == NULL){
+        return;
+    }
+    cycles = (cycles > s_readCost) ? (cycles - s_readCost) : 0U;
+    if (cycles < r->min) r->min = cycles;
+    if (cycles > r->max) r->max = cycles;
+    r->sum += cycles;
+    r->samples++;
+}
+
+uint8_t BENCH_GetResultCount(void){
+    return s_resultCount;
+}
+
+const bench_result_t *BENCH_GetResult(uint8_t index){
+    return (index < s_resultCount) ? &s_results[index] : NULL;
+}
+
+/* ================= Semihosting output ================= */
+
+static void BENCH_Write(const char *text){
+    register uint32_t op __asm("r0") = BENCH_SYS_WRITE0;
+    register const char *arg __asm("r1") = text;
+
+    __asm volatile("BKPT 0xAB" : "+r"(op) : "r"(arg) : "memory");
+}
+
+static void BENCH_Report(void){
+    char line[BENCH_LINE_CHARS];
+    uint8_t i;
+
+    (void)snprintf(line, sizeof(line),
+                   "\nBENCH_BEGIN,core_hz=%lu,tick_us=%u,read_cost=%lu,stats=%u,tickless=%u,"
+                   "telemetry=%u,nvic_profile=%u,adc_irq=%u,adc_dma=%u\n",
+                   (unsigned long)SystemCoreClock, (unsigned)RMS_TICK_US, (unsigned long)s_readCost,
+                   (unsigned)RMS_STATS, (unsigned)RMS_TICKLESS, (unsigned)RMS_TELEMETRY,
+                   (unsigned)NVIC_PROFILE, (unsigned)ADC_USE_IRQ, (unsigned)ADC_USE_DMA);
+    BENCH_Write(line);
+
+    for (i = 0U; i < s_resultCount; i++){
+        const bench_result_t *r = &s_results[i];
+        uint32_t avg = (r->samples == 0U) ? 0U : (uint32_t)(r->sum / r->samples);
+
+        (void)snprintf(line, sizeof(line), "BENCH,%s,%lu,%lu,%lu,%lu\n", r->name,
+                       (unsigned long)r->samples, (unsigned long)((r->samples == 0U) ? 0U : r->min),
+                       (unsigned long)avg, (unsigned long)r->max);
+        BENCH_Write(line);
+    }
+    BENCH_Write("BENCH_END\n");
+}
+
+/* ================= Benchmarks ================= */
+
+/* Shortest interval between two consecutive counter reads; subtracted everywhere */
+static void BENCH_CalibrateReadCost(void){
+    uint32_t best = UINT32_MAX;
+    uint32_t n;
+
+    for (n = 0U; n < BENCH_READ_COST_SAMPLES; n++){
+        uint32_t t0 = DWT_GetCycles();
+        uint32_t t1 = DWT_GetCycles();
+        if ((t1 - t0) < best) best = t1 - t0;
+    }
+    s_readCost = best;
+}
+
+/* Dispatched in place of every thread: just marks when the job body runs */
+static void BENCH_Job(void){
+    BENCH_Stamp(BENCH_STAMP_JOB_ENTRY);
+    BENCH_Stamp(BENCH_STAMP_JOB_EXIT);
+}
+
+/* Tick ISR and dispatcher. The loop keeps sampling the counter until the tick
+ * moves, so the last sample before the interrupt and the first one after it bracket
+ * the hardware entry and exit (plus at most one loop iteration). The jobs released
+ * by that tick are then dispatched with the tick held off. */
+static void BENCH_TickAndDispatch(void){
+    void (*saved[RMS_MAX_THREADS])(void);
+    uint8_t count = RMS_GetThreadCount();
+    bench_result_t *entry = BENCH_Open("pit_isr_entry");
+    bench_result_t *body  = BENCH_Open("pit_isr_body");
+    bench_result_t *leave = BENCH_Open("pit_isr_exit");
+    bench_result_t *in    = BENCH_Open("dispatch_to_job");
+    bench_result_t *out   = BENCH_Open("job_to_dispatch");
+    bench_result_t *idle  = BENCH_Open("dispatch_empty");
+    uint32_t n;
+    uint8_t i;
+
+    for (i = 0U; i < count; i++){
+        saved[i] = ThreadTable[i].ThreadHandler;
+        ThreadTable[i].ThreadHandler = BENCH_Job;
+    }
+
+    for (n = 0U; n < BENCH_SAMPLES; n++){
+        uint32_t tick = RMS_GetSystemTick();
+        uint32_t before, after;
+        nvic_critical_t crit;
+
+        do {
+            before = DWT_GetCycles();
+        } while (RMS_GetSystemTick() == tick);
+        after = DWT_GetCycles();
+
+        BENCH_Add(entry, BenchStamp[BENCH_STAMP_ISR_ENTRY] - before);
+        BENCH_Add(body,  BenchStamp[BENCH_STAMP_ISR_EXIT] - BenchStamp[BENCH_STAMP_ISR_ENTRY]);
+        BENCH_Add(leave, after - BenchStamp[BENCH_STAMP_ISR_EXIT]);
+
+        crit = NVIC_enter_critical(RMS_CEILING_TICK);
+        while (true){
+            bool ran;
+
+            before = DWT_GetCycles();
+            ran = RMS_DispatchNext();
+            after = DWT_GetCycles();
+            if (!ran){
+                BENCH_Add(idle, after - before);
+                break;
+            }
+            BENCH_Add(in,  BenchStamp[BENCH_STAMP_JOB_ENTRY] - before);
+            BENCH_Add(out, after - BenchStamp[BENCH_STAMP_JOB_EXIT]);
+        }
+        NVIC_exit_critical(crit);
+    }
+
+    for (i = 0U; i < count; i++){
+        ThreadTable[i].ThreadHandler = saved[i];
+    }
+}
+
+#if !ADC_USE_IRQ && !ADC_USE_DMA
+/* ADC_ConvertOnce() for every clock source, divider and hardware averaging setting */
+static void BENCH_AdcConversion(void){
+    static const struct {
+        adc16_clock_source_t source;
+        const char *name;
+    } sources[] = {
+        { kADC16_ClockSourceAlt0,              "bus"   },
+        { kADC16_ClockSourceAsynchronousClock, "adack" },
+    };
+    static const adc16_clock_divider_t dividers[] = {
+        kADC16_ClockDivider1, kADC16_ClockDivider2, kADC16_ClockDivider4, kADC16_ClockDivider8
+    };
+    static const struct {
+        adc16_hardware_average_mode_t mode;
+        uint8_t samples;
+    } averages[] = {
+        { kADC16_HardwareAverageDisabled, 1U  },
+        { kADC16_HardwareAverageCount4,   4U  },
+        { kADC16_HardwareAverageCount8,   8U  },
+        { kADC16_HardwareAverageCount16,  16U },
+        { kADC16_HardwareAverageCount32,  32U },
+    };
+    uint32_t s, d, a, n;
+
+    for (s = 0U; s < (sizeof(sources) / sizeof(sources[0])); s++){
+        for (d = 0U; d < (sizeof(dividers) / sizeof(dividers[0])); d++){
+            uint32_t div = 1UL << d;
+
+            if ((sources[s].source == kADC16_ClockSourceAlt0) &&
+                ((CLOCK_GetFreq(kCLOCK_BusClk) / div) > BENCH_ADCK_MAX_HZ)){
+                continue;   /* Out of the ADC16 clock specification */
+            }
+            for (a = 0U; a < (sizeof(averages) / sizeof(averages[0])); a++){
+                char name[BENCH_NAME_CHARS];
+                bench_result_t *r;
+
+                (void)snprintf(name, sizeof(name), "adc_%s_div%lu_avg%u", sources[s].name,
+                               (unsigned long)div, (unsigned)averages[a].samples);
+                r = BENCH_Open(name);
+                ADC_SetConversionTiming(sources[s].source, dividers[d], averages[a].mode);
+
+                for (n = 0U; n < BENCH_ADC_SAMPLES; n++){
+                    nvic_critical_t crit = NVIC_enter_critical(RMS_CEILING_TICK);
+                    uint32_t t0 = DWT_GetCycles();
+
+                    (void)ADC_ConvertOnce();
+                    BENCH_Add(r, DWT_GetCycles() - t0);
+                    NVIC_exit_critical(crit);
+                }
+            }
+        }
+    }
+
+    /* Back to the driver defaults for the scheduler run */
+    ADC_InitModule();
+}
+#endif
+
+static void BENCH_Formatting(void){
+    bench_result_t *deci = BENCH_Open("fmt_temp_deci");
+    bench_result_t *whole = BENCH_Open("fmt_temp_c");
+    bench_result_t *avg  = BENCH_Open("fmt_avg_temp");
+    uint32_t n;
+
+    for (n = 0U; n < BENCH_SAMPLES; n++){
+        nvic_critical_t crit = NVIC_enter_critical(RMS_CEILING_TICK);
+        uint32_t t0 = DWT_GetCycles();
+        uint32_t t1;
+
+        ADC_FormatTempDeciToAscii((uint16_t)(n % (TEMP_MAX_DECI + 1U)));
+        t1 = DWT_GetCycles();
+        BENCH_Add(deci, t1 - t0);
+
+        t0 = DWT_GetCycles();
+        ADC_FormatTempToAscii((uint8_t)(n % (TEMP_MAX_C + 1U)));
+        t1 = DWT_GetCycles();
+        BENCH_Add(whole, t1 - t0);
+
+        t0 = DWT_GetCycles();
+        ADC_FormatAvgTempToAscii();
+        t1 = DWT_GetCycles();
+        BENCH_Add(avg, t1 - t0);
+        NVIC_exit_critical(crit);
+    }
+}
+
+/* Block kernels on a synthetic ramp; per-block cycles, so divide by BENCH_BATCH_SAMPLES
+ * for a per-sample figure (compare against a build with ADC_SIMD=0) */
+static void BENCH_AdcBatch(void){
+    static uint16_t counts[BENCH_BATCH_SAMPLES] __attribute__((aligned(4)));
+    static uint16_t temps[BENCH_BATCH_SAMPLES] __attribute__((aligned(4)));
+    bench_result_t *conv = BENCH_Open("adc_batch_convert");
+    bench_result_t *mean = BENCH_Open("adc_batch_mean");
+    volatile uint16_t sink;
+    uint32_t n;
+
+    for (n = 0U; n < BENCH_BATCH_SAMPLES; n++){
+        counts[n] = (uint16_t)((n * (ADC_FULL_SCALE_COUNTS / BENCH_BATCH_SAMPLES)) & 0x0FFFU);
+    }
+    for (n = 0U; n < BENCH_SAMPLES; n++){
+        nvic_critical_t crit = NVIC_enter_critical(RMS_CEILING_TICK);
+        uint32_t t0 = DWT_GetCycles();
+        uint32_t t1;
+
+        ADC_CountsToTempDeciBatch(counts, temps, BENCH_BATCH_SAMPLES);
+        t1 = DWT_GetCycles();
+        BENCH_Add(conv, t1 - t0);
+
+        t0 = DWT_GetCycles();
+        sink = ADC_MeanTempDeciBatch(temps, BENCH_BATCH_SAMPLES);
+        t1 = DWT_GetCycles();
+        BENCH_Add(mean, t1 - t0);
+        NVIC_exit_critical(crit);
+    }
+    (void)sink;
+}
+
+#if STACK_GUARD
+/* ================= Stack guard probe ================= */
+
+static volatile uint32_t s_probeAddress = 0U;   /* Guard word the probe reads, 0 = disarmed */
+static volatile bool s_probeHit = false;
+
+/* Only enabled around BENCH_GuardProbe(): outside it bus errors go to HardFault */
+__attribute__((naked))
+void BusFault_Handler(void){
+    __asm volatile(".syntax unified\n"
+                   "TST    LR, #4          \n"
+                   "ITE    EQ              \n"
+                   "MRSEQ  R0, MSP         \n"
+                   "MRSNE  R0, PSP         \n"
+                   "B      BENCH_BusFault  \n");
+}
+
+__attribute__((used))
+static void BENCH_BusFault(uint32_t *frame){
+    uint32_t cfsr = SCB->CFSR;
+
+    if ((s_probeAddress == 0U) || ((cfsr & SCB_CFSR_BFARVALID_Msk) == 0U) || (SCB->BFAR != s_probeAddress)){
+        /* Not the probe: disable and return, the retried access escalates to HardFault */
+        SCB->SHCSR &= ~SCB_SHCSR_BUSFAULTENA_Msk;
+        return;
+    }
+    s_probeHit = true;
+    frame[6] += 4U;                                 /* Skip the LDR.W */
+    SCB->CFSR = cfsr & SCB_CFSR_BUSFAULTSR_Msk;     /* Write-one-to-clear */
+    SYSMPU->CESR = SYSMPU->CESR;                    /* Clears SPERR, VLD stays set */
+}
+
+/* A read of the MSP guard must raise a precise bus error. Times the round trip through
+ * BusFault_Handler; no samples in the report means the guard did not fault. A read
+ * is used rather than a push so the fault is precise and can be stepped over. */
+static void BENCH_GuardProbe(void){
+    bench_result_t *r = BENCH_Open("stack_guard_fault");
+    uint32_t guard = STACK_GetGuard(STACK_MSP);
+    uint32_t n;
+
+    if (guard == 0U){
+        return;
+    }
+    SCB->SHCSR |= SCB_SHCSR_BUSFAULTENA_Msk;
+    __DSB();
+    __ISB();
+    for (n = 0U; n < BENCH_GUARD_PROBES; n++){
+        uint32_t t0, t1, value;
+
+        s_probeHit = false;
+        s_probeAddress = guard;
+        t0 = DWT_GetCycles();
+        __asm volatile("LDR.W  %0, [%1]" : "=r"(value) : "r"(guard) : "memory");
+        t1 = DWT_GetCycles();
+        s_probeAddress = 0U;
+        (void)value;
+        if (s_probeHit){
+            BENCH_Add(r, t1 - t0);
+        }
+    }
+    SCB->SHCSR &= ~SCB_SHCSR_BUSFAULTENA_Msk;
+}
+#endif /* STACK_GUARD */
+
+void BENCH_Run(void){
+    s_resultCount = 0U;
+    /* Leave a running counter alone: RMS_STATS stamps are in flight */
+    if ((DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk) == 0U){
+        DWT_InitCycleCounter();
+    }
+    BENCH_CalibrateReadCost();
+
+    BENCH_TickAndDispatch();
+#if !ADC_USE_IRQ && !ADC_USE_DMA
+    BENCH_AdcConversion();
+#endif
+    BENCH_Formatting();
+    BENCH_AdcBatch();
+#if STACK_GUARD
+    BENCH_GuardProbe();
+#endif
+
+    BENCH_Report();
+}
+
+#endif /* RMS_BENCH */
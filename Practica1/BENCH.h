@@ -0,0 +1,63 @@
+/**
+ * @file    BENCH.h
+ *
+ * @brief On-target micro-benchmarks of the scheduler and ADC hot paths.
+ *
+ * Linked in with RMS_BENCH=1 (RMS.h). Every figure is in core clock cycles measured
+ * with DWT->CYCCNT, with the cost of one counter read subtracted. Results are
+ * printed over semihosting as one CSV line per benchmark:
+ *   BENCH,<name>,<samples>,<min>,<avg>,<max>
+ * between a BENCH_BEGIN line listing the clock and build options and a BENCH_END
+ * line, so the logs of two builds or releases can be diffed line by line.
+ * With STACK_GUARD the stack_guard_fault row checks that reading the MSP guard traps
+ * (BusFault is enabled just for it); zero samples there means the guards are open.
+ * Without a debugger the semihosting BKPT is skipped by semihost_hardfault.c.
+ */
+
+#ifndef BENCH_H_
+#define BENCH_H_
+
+#include <stdint.h>
+#include "DWT.h"
+
+#define BENCH_SAMPLES           256U    /* Tick, dispatch and formatting samples */
+#define BENCH_ADC_SAMPLES       32U     /* Conversions per ADC16 timing setting */
+#define BENCH_BATCH_SAMPLES     64U     /* Samples per block in the batch kernel timings */
+#define BENCH_MAX_RESULTS       64U
+#define BENCH_NAME_CHARS        28U
+/* Highest ADC16 conversion clock tried from the bus clock (12-bit, normal speed) */
+#define BENCH_ADCK_MAX_HZ       18000000U
+
+/* Time stamps written by the code under test */
+typedef enum {
+    BENCH_STAMP_ISR_ENTRY = 0,  /* First statement of the PIT0 tick handler */
+    BENCH_STAMP_ISR_EXIT,       /* Last statement before the handler returns */
+    BENCH_STAMP_JOB_ENTRY,      /* Benchmark job stub entered */
+    BENCH_STAMP_JOB_EXIT,       /* Benchmark job stub about to return */
+    BENCH_STAMP_COUNT
+} bench_stamp_t;
+
+extern volatile uint32_t BenchStamp[BENCH_STAMP_COUNT];
+
+static inline void BENCH_Stamp(bench_stamp_t point){
+    BenchStamp[point] = DWT->CYCCNT;
+}
+
+typedef struct {
+    char     name[BENCH_NAME_CHARS];
+    uint32_t samples;
+    uint32_t min;
+    uint32_t max;
+    uint64_t sum;
+} bench_result_t;
+
+/* Run every benchmark and print the report. Call from thread context with the
+ * scheduler tick already running; ThreadTable handlers are swapped for a stub while
+ * the dispatcher is timed and restored afterwards. */
+void BENCH_Run(void);
+
+/* Results of the last BENCH_Run(), e.g. for inspection from a debugger. */
+uint8_t BENCH_GetResultCount(void);
+const bench_result_t *BENCH_GetResult(uint8_t index);
+
+#endif /* BENCH_H_ */
@@ -0,0 +1,150 @@
+/**
+ * @file    CRASH.c
+ *
+ * @brief Implementation of the fault capture.
+ */
+
+#include "CRASH.h"
+#include "MK64F12.h"
+#include "fsl_debug_console.h"
+#include <string.h>
+
+#define CRASH_FRAME_WORDS   8U
+
+/* Not zeroed by the startup code, so it outlives a reset */
+static crash_record_t s_record __attribute__((section(".noinit")));
+
+#if STACK_GUARD
+/* The faulting stack may be sitting on its guard: the capture runs on this one */
+static uint32_t s_crashStack[CRASH_STACK_WORDS] __attribute__((aligned(8)));
+uint32_t * const CrashStackTop = &s_crashStack[CRASH_STACK_WORDS];
+#endif
+
+/* Rotate-and-add over every word after the checksum field */
+static uint32_t CRASH_Checksum(const crash_record_t *rec){
+    const uint32_t *word = &rec->count;
+    const uint32_t *end  = (const uint32_t *)(rec + 1);
+    uint32_t sum = CRASH_MAGIC;
+
+    while (word < end){
+        sum = ((sum << 5) | (sum >> 27)) + *word++;
+    }
+    return sum;
+}
+
+static bool CRASH_Valid(void){
+    return (s_record.magic == CRASH_MAGIC) && (s_record.checksum == CRASH_Checksum(&s_record));
+}
+
+/* Access error latched by the SYSMPU, e.g. a push into a stack guard */
+static void CRASH_CaptureMpu(void){
+    s_record.mpuAddress = 0U;
+    s_record.mpuDetail  = 0U;
+    s_record.stackId    = STACK_NONE;
+#if STACK_GUARD
+    {
+        uint32_t errors = SYSMPU->CESR & SYSMPU_CESR_SPERR_MASK;
+
+        if (errors != 0U){
+            /* SPERR is MSB first: bit 31 is slave port 0 */
+            uint32_t port = __CLZ(errors);
+
+            s_record.mpuAddress = SYSMPU->SP[port].EAR;
+            s_record.mpuDetail  = SYSMPU->SP[port].EDR;
+            s_record.stackId    = STACK_GuardOwner(s_record.mpuAddress);
+        }
+    }
+#endif
+}
+
+void CRASH_Capture(const uint32_t *frame, uint32_t excReturn){
+    uint32_t count = CRASH_Valid() ? s_record.count : 0U;
+    uint32_t index = RMS_GetRunningThread();
+    uint32_t *regs = &s_record.r0;
+    uint32_t i;
+
+    s_record.magic = 0U;
+    s_record.excReturn = excReturn;
+    s_record.sp    = (uint32_t)frame;
+    s_record.cfsr  = SCB->CFSR;
+    s_record.hfsr  = SCB->HFSR;
+    s_record.mmfar = SCB->MMFAR;
+    s_record.bfar  = SCB->BFAR;
+    CRASH_CaptureMpu();
+
+    /* A stacking fault leaves no frame to read, and reading it would lock up the core */
+    for (i = 0U; i < CRASH_FRAME_WORDS; i++){
+        regs[i] = (s_record.cfsr & CRASH_CFSR_STACKING) ? CRASH_NO_FRAME : frame[i];
+    }
+
+    s_record.tick = RMS_GetSystemTick();
+    s_record.threadIndex = index;
+    if (index < RMS_GetThreadCount()){
+        s_record.thread = ThreadTable[index];
+    } else {
+        memset(&s_record.thread, 0, sizeof(s_record.thread));
+    }
+
+    s_record.count    = count + 1U;
+    s_record.reported = 0U;
+    s_record.checksum = CRASH_Checksum(&s_record);
+    __DSB();
+    s_record.magic = CRASH_MAGIC;
+    __DSB();
+
+    /* With a debugger attached, stop here first so the fault can be inspected live */
+    if (CoreDebug->DHCSR & CoreDebug_DHCSR_C_DEBUGEN_Msk){
+        __BKPT(0);
+    }
+    NVIC_SystemReset();
+    while (1){
+    }
+}
+
+bool CRASH_GetLast(crash_record_t *out){
+    if (!CRASH_Valid()){
+        return false;
+    }
+    *out = s_record;
+    return true;
+}
+
+void CRASH_ReportPrevious(void){
+    if (!CRASH_Valid() || (s_record.reported != 0U)){
+        return;
+    }
+
+    PRINTF("\r\nCRASH #%u: pc=0x%08x lr=0x%08x xpsr=0x%08x sp=0x%08x exc_return=0x%08x",
+           (unsigned)s_record.count, (unsigned)s_record.pc, (unsigned)s_record.lr,
+           (unsigned)s_record.xpsr, (unsigned)s_record.sp, (unsigned)s_record.excReturn);
+    PRINTF("\r\nCRASH: cfsr=0x%08x hfsr=0x%08x", (unsigned)s_record.cfsr, (unsigned)s_record.hfsr);
+    if (s_record.cfsr & CRASH_CFSR_MMARVALID){
+        PRINTF(" mmfar=0x%08x", (unsigned)s_record.mmfar);
+    }
+    if (s_record.cfsr & CRASH_CFSR_BFARVALID){
+        PRINTF(" bfar=0x%08x", (unsigned)s_record.bfar);
+    }
+    if (s_record.mpuDetail != 0U){
+        PRINTF("\r\nCRASH: sysmpu ear=0x%08x edr=0x%08x", (unsigned)s_record.mpuAddress,
+               (unsigned)s_record.mpuDetail);
+        if (s_record.stackId != STACK_NONE){
+            PRINTF(", overflow into the guard of stack %u (%s)", (unsigned)s_record.stackId,
+                   (s_record.stackId == STACK_MSP) ? "msp" : "thread");
+        }
+    }
+    if (s_record.threadIndex < RMS_IDLE_INDEX){
+        PRINTF("\r\nCRASH: tick %u in thread %u (rate %u, state %u, handler 0x%08x)",
+               (unsigned)s_record.tick, (unsigned)s_record.threadIndex,
+               (unsigned)s_record.thread.ThreadRate, (unsigned)s_record.thread.ThreadState,
+               (unsigned)(uintptr_t)s_record.thread.ThreadHandler);
+    } else {
+        PRINTF("\r\nCRASH: tick %u outside any thread", (unsigned)s_record.tick);
+    }
+
+    s_record.reported = 1U;
+    s_record.checksum = CRASH_Checksum(&s_record);
+}
+
+void CRASH_Clear(void){
+    s_record.magic = 0U;
+}
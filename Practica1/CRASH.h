@@ -0,0 +1,80 @@
+/**
+ * @file    CRASH.h
+ *
+ * @brief Fault capture into no-init RAM with immediate reset.
+ *
+ * With CRASH_CAPTURE=1 the HardFault handler (semihost_hardfault.c) still returns
+ * from semihosting BKPTs, but any other fault is recorded here and the MCU is reset
+ * at once instead of spinning until the watchdog fires. The record lives in .noinit,
+ * which the startup code neither clears nor initializes, so it survives the reset and
+ * can be read (and printed) by the next boot. A magic word and a checksum tell a real
+ * record from power-on RAM contents.
+ *
+ * With STACK_GUARD the handler first switches MSP to CrashStack, so a fault raised by
+ * an overflowing MSP still has a stack to be recorded from, and the SYSMPU error names
+ * the guard hit. Only the guard trap itself is checked on target (RMS_BENCH).
+ */
+
+#ifndef CRASH_H_
+#define CRASH_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "RMS.h"
+#include "STACK.h"
+
+/* Build option: 1 = capture and reset, 0 = spin in HardFault_Handler (debug builds) */
+#ifndef CRASH_CAPTURE
+#define CRASH_CAPTURE           1
+#endif
+
+#define CRASH_MAGIC             0xC0DEFA17UL
+#define CRASH_NO_FRAME          0xFFFFFFFFUL    /* Stacked registers unreadable */
+#define CRASH_STACK_WORDS       128U            /* Handler stack with STACK_GUARD */
+
+/* CFSR bits (SCB->CFSR = MMFSR | BFSR << 8 | UFSR << 16) */
+#define CRASH_CFSR_MMARVALID    (1UL << 7)      /* MMFAR holds the faulting address */
+#define CRASH_CFSR_BFARVALID    (1UL << 15)     /* BFAR holds the faulting address */
+#define CRASH_CFSR_STACKING     ((1UL << 4) | (1UL << 12))  /* MSTKERR | STKERR */
+
+typedef struct {
+    uint32_t magic;         /* CRASH_MAGIC while the record is valid */
+    uint32_t checksum;      /* Over every field below */
+    uint32_t count;         /* Faults captured since the RAM was last powered */
+    uint32_t reported;      /* Set once CRASH_ReportPrevious() printed the record */
+    /* Exception frame stacked by the core (CRASH_NO_FRAME if stacking itself faulted) */
+    uint32_t r0, r1, r2, r3, r12, lr, pc, xpsr;
+    uint32_t sp;            /* Address of the stacked frame */
+    uint32_t excReturn;     /* LR on entry: which stack and mode faulted */
+    uint32_t cfsr;
+    uint32_t hfsr;
+    uint32_t mmfar;         /* Valid when cfsr & CRASH_CFSR_MMARVALID */
+    uint32_t bfar;          /* Valid when cfsr & CRASH_CFSR_BFARVALID */
+    uint32_t tick;          /* RMS_GetSystemTick() at the fault */
+    uint32_t threadIndex;   /* RMS_GetRunningThread(), RMS_IDLE_INDEX outside any job */
+    ThdObj   thread;        /* Copy of ThreadTable[threadIndex] (zeros when idle) */
+    /* SYSMPU access error, if any (STACK_GUARD) */
+    uint32_t mpuAddress;    /* SYSMPU_EARn of the reporting slave port */
+    uint32_t mpuDetail;     /* SYSMPU_EDRn: master, attributes, read/write (0 = no error) */
+    uint32_t stackId;       /* STACK_GuardOwner(mpuAddress), STACK_NONE if not a guard */
+} crash_record_t;
+
+#if STACK_GUARD
+/* Top of the handler stack, loaded into MSP by HardFault_Handler before capturing */
+extern uint32_t * const CrashStackTop;
+#endif
+
+/* Called by HardFault_Handler with the stacked frame and EXC_RETURN; never returns. */
+void CRASH_Capture(const uint32_t *frame, uint32_t excReturn) __attribute__((noreturn));
+
+/* Copy of the record left by the last captured fault. Returns false if there is none. */
+bool CRASH_GetLast(crash_record_t *out);
+
+/* Print the last record once over the debug console (call before the scheduler starts,
+ * while PRINTF is still usable). Later boots stay quiet until the next fault. */
+void CRASH_ReportPrevious(void);
+
+/* Invalidate the record (the fault count restarts as well). */
+void CRASH_Clear(void);
+
+#endif /* CRASH_H_ */
@@ -0,0 +1,14 @@
+/**
+ * @file    DWT.c
+ *
+ * @brief Implementation of the DWT cycle counter helpers.
+ */
+
+#include "DWT.h"
+
+void DWT_InitCycleCounter(void){
+    /* DWT is part of the trace block, which is off unless a debugger enabled it */
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0U;
+    DWT->CTRL  |= DWT_CTRL_CYCCNTENA_Msk;
+}
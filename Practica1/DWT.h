@@ -0,0 +1,25 @@
+/**
+ * @file    DWT.h
+ *
+ * @brief Cycle counter helpers based on the Cortex-M4 DWT unit.
+ *
+ * DWT->CYCCNT counts core clock cycles and wraps every 2^32 cycles (about 35 s
+ * at 120 MHz), so intervals must always be computed with unsigned subtraction
+ * of two stamps.
+ */
+
+#ifndef DWT_H_
+#define DWT_H_
+
+#include <stdint.h>
+#include "MK64F12.h"
+
+/* Enable the trace block and start the free-running cycle counter. */
+void DWT_InitCycleCounter(void);
+
+/* Current core cycle count. */
+static inline uint32_t DWT_GetCycles(void){
+    return DWT->CYCCNT;
+}
+
+#endif /* DWT_H_ */
@@ -0,0 +1,64 @@
+/**
+ * @file    EVENT.c
+ *
+ * @brief Implementation of the GPIO edge event sources.
+ */
+
+#include "EVENT.h"
+
+#if RMS_SPORADIC
+#include "fsl_common.h"
+#include "fsl_port.h"
+#include "fsl_gpio.h"
+
+/* ThreadTable index the events are posted to */
+static uint8_t s_server = 0U;
+
+static void EVENT_InitPin(PORT_Type *port, GPIO_Type *gpio, uint32_t pin){
+    const port_pin_config_t pinConfig = {
+        .pullSelect          = kPORT_PullUp,
+        .slewRate            = kPORT_SlowSlewRate,
+        .passiveFilterEnable = kPORT_PassiveFilterEnable,
+        .openDrainEnable     = kPORT_OpenDrainDisable,
+        .driveStrength       = kPORT_LowDriveStrength,
+        .mux                 = kPORT_MuxAsGpio,
+        .lockRegister        = kPORT_UnlockRegister,
+    };
+    const gpio_pin_config_t gpioConfig = {kGPIO_DigitalInput, 0U};
+
+    PORT_SetPinConfig(port, pin, &pinConfig);
+    GPIO_PinInit(gpio, pin, &gpioConfig);
+    PORT_ClearPinsInterruptFlags(port, 1UL << pin);
+    PORT_SetPinInterruptConfig(port, pin, kPORT_InterruptFallingEdge);
+}
+
+void EVENT_Init(uint8_t serverIndex){
+    s_server = serverIndex;
+
+    CLOCK_EnableClock(kCLOCK_PortA);
+    CLOCK_EnableClock(kCLOCK_PortC);
+    EVENT_InitPin(EVENT_SW2_PORT, EVENT_SW2_GPIO, EVENT_SW2_PIN);
+    EVENT_InitPin(EVENT_SW3_PORT, EVENT_SW3_GPIO, EVENT_SW3_PIN);
+}
+
+void PORTA_IRQHandler(void){
+    uint32_t flags = PORT_GetPinsInterruptFlags(EVENT_SW3_PORT);
+
+    PORT_ClearPinsInterruptFlags(EVENT_SW3_PORT, flags);
+    if (flags & (1UL << EVENT_SW3_PIN)){
+        RMS_SporadicPost(s_server, EVENT_SW3);
+    }
+    __DSB();
+}
+
+void PORTC_IRQHandler(void){
+    uint32_t flags = PORT_GetPinsInterruptFlags(EVENT_SW2_PORT);
+
+    PORT_ClearPinsInterruptFlags(EVENT_SW2_PORT, flags);
+    if (flags & (1UL << EVENT_SW2_PIN)){
+        RMS_SporadicPost(s_server, EVENT_SW2);
+    }
+    __DSB();
+}
+
+#endif /* RMS_SPORADIC */
@@ -0,0 +1,40 @@
+/**
+ * @file    EVENT.h
+ *
+ * @brief GPIO edge events for the sporadic server (RMS_SPORADIC).
+ *
+ * The FRDM-K64F push buttons raise a PORT interrupt on the falling edge. The
+ * handler only clears the flag and posts an event bit to the server thread with
+ * RMS_SporadicPost(), which releases it right away when budget is left, so a press
+ * is handled within one dispatch without any thread polling the pin. The server's
+ * budget bounds the CPU an event storm (or a bouncing contact) can take away from
+ * the periodic threads.
+ */
+
+#ifndef EVENT_H_
+#define EVENT_H_
+
+#include <stdint.h>
+#include "RMS.h"
+
+/* -------- Hardware selection (FRDM-K64F) -------- */
+#define EVENT_SW2_PORT          PORTC
+#define EVENT_SW2_GPIO          GPIOC
+#define EVENT_SW2_PIN           6U
+#define EVENT_SW3_PORT          PORTA
+#define EVENT_SW3_GPIO          GPIOA
+#define EVENT_SW3_PIN           4U      /* Defaults to NMI_b: muxed to GPIO by EVENT_Init() */
+
+/* Event bits posted to the server, fetched with RMS_SporadicTake() */
+#define EVENT_SW2               (1UL << 0)
+#define EVENT_SW3               (1UL << 1)
+
+/* Below the tick: RMS_SporadicPost() raises BASEPRI to RMS_CEILING_TICK */
+#define EVENT_IRQ_PRIORITY      PRIORITY_2
+
+/* Configure both buttons as pulled-up inputs interrupting on the falling edge and
+ * route their events to ThreadTable[serverIndex]. The PORT interrupt lines are
+ * enabled by NVIC_init() (see NVIC_config.h). */
+void EVENT_Init(uint8_t serverIndex);
+
+#endif /* EVENT_H_ */
@@ -0,0 +1,198 @@
+/**
+ * @file    HEALTH.c
+ *
+ * @brief Implementation of the scheduler health monitor.
+ */
+
+#include "HEALTH.h"
+
+#if HEALTH_MONITOR
+#include "fsl_common.h"
+#include "fsl_wdog.h"
+#include "fsl_ewm.h"
+#include "fsl_debug_console.h"
+#include <string.h>
+
+volatile uint32_t HealthLastCheckIn[RMS_MAX_THREADS];
+
+static uint32_t s_windowStart = 0U;
+static uint32_t s_lastService = 0U;
+static volatile uint32_t s_unhealthy = 0U;
+static bool s_snapshotTaken = false;
+
+/* Survives the watchdog reset for the next boot */
+static health_snapshot_t s_snapshot __attribute__((section(".noinit")));
+
+static uint32_t HEALTH_Checksum(const health_snapshot_t *snap){
+    const uint32_t *word = &snap->reported;
+    const uint32_t *end  = (const uint32_t *)(snap + 1);
+    uint32_t sum = HEALTH_MAGIC;
+
+    while (word < end){
+        sum = ((sum << 5) | (sum >> 27)) + *word++;
+    }
+    return sum;
+}
+
+void HEALTH_Init(void){
+    wdog_config_t wdogConfig;
+    ewm_config_t ewmConfig;
+
+    memset((void *)HealthLastCheckIn, 0, sizeof(HealthLastCheckIn));
+    s_windowStart = RMS_GetSystemTick();
+    s_lastService = s_windowStart;
+    s_unhealthy   = 0U;
+
+    /* Early warning: interrupt only, EWM_out is not wired to the reset line */
+    EWM_GetDefaultConfig(&ewmConfig);
+    ewmConfig.enableInterrupt  = true;
+    ewmConfig.compareLowValue  = 0U;
+    ewmConfig.compareHighValue = (uint8_t)HEALTH_EWM_TIMEOUT_MS;
+    EWM_Init(EWM, &ewmConfig);
+
+    /* Reset, preceded by the interrupt that gives the handler a last look;
+     * stopped while the debugger halts the core */
+    WDOG_GetDefaultConfig(&wdogConfig);
+    wdogConfig.clockSource        = kWDOG_LpoClockSource;
+    wdogConfig.prescaler          = kWDOG_ClockPrescalerDivide1;
+    wdogConfig.workMode.enableDebug = false;
+    wdogConfig.enableUpdate       = true;
+    wdogConfig.enableInterrupt    = true;
+    wdogConfig.enableWindowMode   = false;
+    wdogConfig.timeoutValue       = HEALTH_WDOG_TIMEOUT_MS;
+    WDOG_Init(WDOG, &wdogConfig);
+    /* WDOG_OR_EWM_IRQ is enabled by NVIC_init() (see NVIC_config.h) */
+}
+
+bool HEALTH_CheckTiming(void){
+    uint8_t count = RMS_GetThreadCount();
+    bool fits = true;
+    uint8_t i;
+
+    for (i = 0U; i < count; i++){
+        uint32_t period = (ThreadTable[i].ServerBudgetUs != 0U) ? ThreadTable[i].ThreadRate : RMS_GetThreadPeriod(i);
+
+        if ((period != 0U) && (RMS_TICKS_TO_MS(period + HEALTH_GRACE_TICKS) >= HEALTH_EWM_TIMEOUT_MS)){
+            PRINTF("\r\nHEALTH: thread %u period %u ticks plus grace reaches the %u ms EWM timeout",
+                   (unsigned)i, (unsigned)period, (unsigned)HEALTH_EWM_TIMEOUT_MS);
+            fits = false;
+        }
+    }
+    return fits;
+}
+
+void HEALTH_Supervise(uint32_t tick){
+    uint8_t count = RMS_GetThreadCount();
+    uint32_t late = 0U;
+    uint8_t i;
+
+    if ((uint32_t)(tick - s_windowStart) < HEALTH_WINDOW_TICKS){
+        return;
+    }
+    s_windowStart = tick;
+
+    for (i = 0U; i < count; i++){
+        uint32_t period = RMS_GetThreadPeriod(i);
+        uint32_t since = tick - HealthLastCheckIn[i];
+
+        if (period == 0U){
+            /* Shed by the scheduler mode: nothing to wait for */
+            since = 0U;
+        }
+        else if (ThreadTable[i].ServerBudgetUs != 0U){
+            /* Sporadic server: only a pending activation can be late, from its release */
+            since = (ThreadTable[i].ThreadState == STANDBY) ? 0U : (tick - ThreadTable[i].SystemTime);
+        }
+        if (since > (period + HEALTH_GRACE_TICKS)){
+            late |= RMS_READY_BIT(i);
+        }
+    }
+    s_unhealthy = late;
+
+    /* No service at all while any thread is late: the EWM fires, then the WDOG */
+    if (late == 0U){
+        WDOG_Refresh(WDOG);
+        EWM_Refresh(EWM);
+        s_lastService = tick;
+    }
+}
+
+uint32_t HEALTH_GetUnhealthy(void){
+    return s_unhealthy;
+}
+
+/* Copy of the scheduler state. Runs above every BASEPRI ceiling, so the values come
+ * from wherever the interrupted code left them; good enough for a post-mortem. */
+static void HEALTH_Snapshot(void){
+    uint8_t count = RMS_GetThreadCount();
+    uint8_t i;
+
+    s_snapshot.magic         = 0U;
+    s_snapshot.reported      = 0U;
+    s_snapshot.tick          = RMS_GetSystemTick();
+    s_snapshot.lastService   = s_lastService;
+    s_snapshot.unhealthy     = s_unhealthy;
+    s_snapshot.runningThread = RMS_GetRunningThread();
+    s_snapshot.threadCount   = (count < HEALTH_MAX_THREADS) ? count : HEALTH_MAX_THREADS;
+
+    memset(s_snapshot.thread, 0, sizeof(s_snapshot.thread));
+    for (i = 0U; i < s_snapshot.threadCount; i++){
+        health_thread_t *t = &s_snapshot.thread[i];
+
+        t->lastCheckIn    = HealthLastCheckIn[i];
+        t->deadlineMisses = RMS_GetDeadlineMisses(i);
+        t->rateDivider    = RMS_GetRateDivider(i);
+        t->state          = ThreadTable[i].ThreadState;
+#if RMS_STATS
+        t->jobs             = ThreadStats[i].Jobs;
+        t->execMaxCycles    = ThreadStats[i].ExecMax;
+        t->latencyMaxCycles = ThreadStats[i].LatencyMax;
+#endif
+    }
+
+    s_snapshot.checksum = HEALTH_Checksum(&s_snapshot);
+    __DSB();
+    s_snapshot.magic = HEALTH_MAGIC;
+    __DSB();
+    s_snapshotTaken = true;
+}
+
+/* Shared vector: EWM early warning, or the WDOG's last 256 bus clocks before reset */
+void WDOG_EWM_IRQHandler(void){
+    if (WDOG_GetStatusFlags(WDOG) & kWDOG_TimeoutFlag){
+        WDOG_ClearStatusFlags(WDOG, kWDOG_TimeoutFlag);
+        if (!s_snapshotTaken){
+            HEALTH_Snapshot();
+        }
+    } else {
+        /* EWM_out stays asserted until a service: mask it so it fires only once */
+        EWM_DisableInterrupts(EWM, kEWM_InterruptEnable);
+        HEALTH_Snapshot();
+    }
+    __DSB();
+}
+
+void HEALTH_ReportPrevious(void){
+    uint32_t i;
+
+    if ((s_snapshot.magic != HEALTH_MAGIC) || (s_snapshot.checksum != HEALTH_Checksum(&s_snapshot)) ||
+        (s_snapshot.reported != 0U)){
+        return;
+    }
+
+    PRINTF("\r\nHEALTH: watchdog expired at tick %u, last service at tick %u, late threads 0x%08x, running %u",
+           (unsigned)s_snapshot.tick, (unsigned)s_snapshot.lastService,
+           (unsigned)s_snapshot.unhealthy, (unsigned)s_snapshot.runningThread);
+    for (i = 0U; i < s_snapshot.threadCount; i++){
+        const health_thread_t *t = &s_snapshot.thread[i];
+
+        PRINTF("\r\nHEALTH: thread %u last job at tick %u, state %u, misses %u, divider %u, jobs %u, exec max %u cycles",
+               (unsigned)i, (unsigned)t->lastCheckIn, (unsigned)t->state, (unsigned)t->deadlineMisses,
+               (unsigned)t->rateDivider, (unsigned)t->jobs, (unsigned)t->execMaxCycles);
+    }
+
+    s_snapshot.reported = 1U;
+    s_snapshot.checksum = HEALTH_Checksum(&s_snapshot);
+}
+
+#endif /* HEALTH_MONITOR */
@@ -0,0 +1,102 @@
+/**
+ * @file    HEALTH.h
+ *
+ * @brief Scheduler health monitor driving the WDOG and the EWM.
+ *
+ * Every thread checks in when a job completes. At each HEALTH_WINDOW_TICKS boundary
+ * the tick interrupt verifies that every thread checked in within its current period
+ * (its rate in the current scheduler mode times its rate divider) plus HEALTH_GRACE_TICKS,
+ * and only then services both watchdogs. A thread shed by the mode is not checked; a
+ * sporadic server is only checked while an activation is pending,
+ * against the tick it was released at. A stuck thread, a starved one, or a dead tick stops the service:
+ * the EWM expires first and its interrupt snapshots the scheduler state into no-init
+ * RAM, then the WDOG resets the MCU. The next boot can print the snapshot.
+ *
+ * Both watchdogs run from the 1 kHz LPO, so their timeouts are in milliseconds.
+ */
+
+#ifndef HEALTH_H_
+#define HEALTH_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "RMS.h"
+
+/* Build option: 1 = health monitor with WDOG/EWM, 0 = watchdogs left disabled */
+#ifndef HEALTH_MONITOR
+#define HEALTH_MONITOR          0
+#endif
+#if HEALTH_MONITOR && RMS_BENCH
+#error "HEALTH_MONITOR: the benchmark image holds the tick off for long stretches"
+#endif
+
+#define HEALTH_WINDOW_TICKS     10U     /* Evaluation (and service) period */
+#define HEALTH_GRACE_TICKS      2U      /* Allowed lateness past a thread's period */
+#define HEALTH_EWM_TIMEOUT_MS   30U     /* Early warning after the last service (<= 254) */
+#define HEALTH_WDOG_TIMEOUT_MS  50U     /* Reset after the last service */
+#define HEALTH_MAX_THREADS      8U      /* Threads kept in the snapshot */
+
+/* Above everything else, so a handler stuck at any other priority still gets its
+ * snapshot. PRIORITY_0 is never masked by BASEPRI: the handler only reads. */
+#define HEALTH_IRQ_PRIORITY     PRIORITY_0
+
+_Static_assert(HEALTH_EWM_TIMEOUT_MS < HEALTH_WDOG_TIMEOUT_MS, "the EWM must warn before the WDOG resets");
+/* Windows are in ticks, timeouts in LPO milliseconds: a healthy system services once
+ * per window, so the window must end before the EWM expires whatever RMS_TICK_US is */
+_Static_assert(RMS_TICKS_TO_MS(HEALTH_WINDOW_TICKS) < HEALTH_EWM_TIMEOUT_MS,
+               "HEALTH_WINDOW_TICKS at RMS_TICK_US does not fit in HEALTH_EWM_TIMEOUT_MS");
+_Static_assert(HEALTH_EWM_TIMEOUT_MS <= 254U, "EWM compare value is 8 bits");
+
+typedef struct {
+    uint32_t lastCheckIn;       /* Tick of the latest completed job */
+    uint32_t deadlineMisses;
+    uint32_t jobs;              /* Completed jobs (RMS_STATS, else 0) */
+    uint32_t execMaxCycles;     /* (RMS_STATS, else 0) */
+    uint32_t latencyMaxCycles;  /* (RMS_STATS, else 0) */
+    uint8_t  rateDivider;
+    uint8_t  state;             /* ThdState */
+    uint8_t  reserved[2];
+} health_thread_t;
+
+typedef struct {
+    uint32_t magic;             /* HEALTH_MAGIC while valid */
+    uint32_t checksum;          /* Over every field below */
+    uint32_t reported;          /* Set once HEALTH_ReportPrevious() printed it */
+    uint32_t tick;              /* RMS_GetSystemTick() at the warning */
+    uint32_t lastService;       /* Tick of the last watchdog service */
+    uint32_t unhealthy;         /* RMS_READY_BIT mask of the threads found late */
+    uint32_t runningThread;     /* RMS_GetRunningThread() at the warning */
+    uint32_t threadCount;
+    health_thread_t thread[HEALTH_MAX_THREADS];
+} health_snapshot_t;
+
+#define HEALTH_MAGIC            0x4EA17400UL
+
+/* Last completed job of every thread, written only by the thread itself */
+extern volatile uint32_t HealthLastCheckIn[RMS_MAX_THREADS];
+
+/* Job of ThreadTable[index] completed at `tick`. */
+static inline void HEALTH_CheckIn(uint32_t index, uint32_t tick){
+    HealthLastCheckIn[index] = tick;
+}
+
+/* Check the thread set against the timeouts: false when a thread's current period
+ * plus HEALTH_GRACE_TICKS reaches HEALTH_EWM_TIMEOUT_MS, i.e. a stuck thread would
+ * only be found late after the EWM budget a dead tick gets. Periods change with the
+ * mode and the rate dividers, so this is a run-time check; call before HEALTH_Init(). */
+bool HEALTH_CheckTiming(void);
+
+/* Configure and start the WDOG and the EWM; call right before the tick starts. */
+void HEALTH_Init(void);
+
+/* Called from the tick interrupt with the current tick: evaluates the window and
+ * services the watchdogs when every thread is on time. */
+void HEALTH_Supervise(uint32_t tick);
+
+/* Threads late at the last evaluation (RMS_READY_BIT mask, 0 = healthy). */
+uint32_t HEALTH_GetUnhealthy(void);
+
+/* Print the snapshot left by a watchdog reset once, before the scheduler starts. */
+void HEALTH_ReportPrevious(void);
+
+#endif /* HEALTH_H_ */
@@ -11,14 +11,185 @@
  */
 
 #include "NVIC.h"
+#include "NVIC_config.h"
+#if NVIC_PROFILE
+#include "DWT.h"
+#include <stddef.h>
+#include <string.h>
+#endif
+
+/**Build-time checks of NVIC_IRQ_TABLE, one set per row*/
+#define NVIC_IRQ_CHECK(irq, prio) \
+	_Static_assert(((irq) >= DMA_CH0_IRQ) && ((irq) <= ETHERNET_MAC3_IRQ), #irq " is not a valid interrupt_t"); \
+	_Static_assert(((prio) >= PRIORITY_0) && ((prio) <= PRIORITY_15), #irq " priority out of range"); \
+	_Static_assert((NVIC_BASEPRI_THRESHOLD == PRIORITY_0) || ((prio) < NVIC_BASEPRI_THRESHOLD), \
+				   #irq " would be masked by NVIC_BASEPRI_THRESHOLD");
+NVIC_IRQ_TABLE(NVIC_IRQ_CHECK)
+
+/**A repeated IRQ repeats an enumerator name, which does not compile*/
+#define NVIC_IRQ_UNIQUE(irq, prio) NVIC_IRQ_LISTED_##irq,
+enum { NVIC_IRQ_TABLE(NVIC_IRQ_UNIQUE) NVIC_IRQ_LISTED_COUNT };
+
+#define NVIC_IRQ_ROW(irq, prio) { (irq), (prio) },
+static const nvic_irq_config_t nvic_irq_table[] = { NVIC_IRQ_TABLE(NVIC_IRQ_ROW) };
+
+#if NVIC_PROFILE
+/**Exceptions ahead of IRQ 0 in the vector table*/
+#define NVIC_CORE_VECTORS		16U
+#define NVIC_IRQ_VECTORS		(NUMBER_OF_INT_VECTORS - NVIC_CORE_VECTORS)
+/**VTOR needs the table aligned to its size rounded up to a power of two*/
+#define NVIC_RAM_VECTORS_ALIGN	512U
+/**Nesting needs a strictly higher priority, so 16 levels nest at most 16 deep*/
+#define NVIC_PROFILE_MAX_DEPTH	16U
+#define NVIC_PROFILE_NO_SLOT	0xFFU
+
+_Static_assert((NUMBER_OF_INT_VECTORS * sizeof(uint32_t)) <= NVIC_RAM_VECTORS_ALIGN,
+			   "NVIC_RAM_VECTORS_ALIGN too small for the vector table");
+_Static_assert(NVIC_PROFILE_MAX_IRQS < NVIC_PROFILE_NO_SLOT, "NVIC_PROFILE_MAX_IRQS too large");
+
+typedef void (*nvic_handler_t)(void);
+
+static uint32_t nvic_ram_vectors[NUMBER_OF_INT_VECTORS] __attribute__((aligned(NVIC_RAM_VECTORS_ALIGN)));
+static bool nvic_ram_vectors_active = false;
+
+/**IRQ number -> profile slot*/
+static uint8_t nvic_profile_slot[NVIC_IRQ_VECTORS];
+static uint8_t nvic_profile_slots_used = 0;
+static nvic_handler_t nvic_profile_handler[NVIC_PROFILE_MAX_IRQS];
+static volatile nvic_latency_probe_t nvic_profile_probe[NVIC_PROFILE_MAX_IRQS];
+static nvic_irq_profile_t nvic_profile[NVIC_PROFILE_MAX_IRQS];
+
+/**Nesting bookkeeping. Handlers nest strictly LIFO, so a preempting handler has
+	restored nvic_depth before the preempted one runs again. The entries shared between
+	levels (nvic_depth, the preempted handler's Preemptions and nested cycles) are
+	updated with PRIMASK set: a handler preempting half way through such an update
+	would read the same depth and its own update would be lost*/
+static uint8_t nvic_depth = 0;
+static uint8_t nvic_max_depth = 0;
+static uint8_t nvic_active_slot[NVIC_PROFILE_MAX_DEPTH];
+static uint32_t nvic_nested_cycles[NVIC_PROFILE_MAX_DEPTH];
+
+static void NVIC_profile_clear(nvic_irq_profile_t *profile)
+{
+	memset(profile, 0, sizeof(*profile));
+	profile->ExecMin = UINT32_MAX;
+	profile->StackMin = UINT32_MAX;
+}
+
+/**Common entry of every profiled vector: looks up the real handler by IPSR and times it*/
+static void NVIC_profile_trampoline(void)
+{
+	uint32_t start = DWT_GetCycles();
+	uint32_t sp = __get_MSP();
+	uint8_t slot = nvic_profile_slot[__get_IPSR() - NVIC_CORE_VECTORS];
+	nvic_irq_profile_t *profile = &nvic_profile[slot];
+	nvic_latency_probe_t probe = nvic_profile_probe[slot];
+	uint32_t primask;
+	uint32_t total;
+	uint32_t exec;
+	uint8_t depth;
+
+	if(sp < profile->StackMin)
+	{
+		profile->StackMin = sp;
+	}
+
+	if(NULL != probe)
+	{
+		uint32_t latency = probe();
+		if(latency > profile->LatencyMax)
+		{
+			profile->LatencyMax = latency;
+		}
+		profile->LatencySum += latency;
+		profile->LatencySamples++;
+	}
+
+	/**Fields of this slot are only written by this IRQ: no masking needed for them*/
+	primask = __get_PRIMASK();
+	__disable_irq();
+	depth = nvic_depth;
+	if(0 != depth)
+	{
+		nvic_profile[nvic_active_slot[depth - 1]].Preemptions++;
+	}
+	nvic_active_slot[depth] = slot;
+	nvic_nested_cycles[depth] = 0;
+	nvic_depth = depth + 1;
+	if(nvic_depth > nvic_max_depth)
+	{
+		nvic_max_depth = nvic_depth;
+	}
+	__set_PRIMASK(primask);
+
+	nvic_profile_handler[slot]();
+
+	__disable_irq();
+	total = DWT_GetCycles() - start;
+	exec = total - nvic_nested_cycles[depth];
+	nvic_depth = depth;
+	if(0 != depth)
+	{
+		/**Charge the whole nested run to the preempted handler's exclusion*/
+		nvic_nested_cycles[depth - 1] += total;
+	}
+	__set_PRIMASK(primask);
+
+	profile->Count++;
+	if(exec < profile->ExecMin)
+	{
+		profile->ExecMin = exec;
+	}
+	if(exec > profile->ExecMax)
+	{
+		profile->ExecMax = exec;
+	}
+	profile->ExecSum += exec;
+}
+
+/**Moves the vector table to RAM on first use and points the IRQ at the trampoline*/
+static void NVIC_profile_install(interrupt_t interrupt_number)
+{
+	uint32_t primask = __get_PRIMASK();
+	uint8_t slot;
+
+	__disable_irq();
+	if(!nvic_ram_vectors_active)
+	{
+		memcpy(nvic_ram_vectors, (const void *)SCB->VTOR, sizeof(nvic_ram_vectors));
+		memset(nvic_profile_slot, NVIC_PROFILE_NO_SLOT, sizeof(nvic_profile_slot));
+		DWT_InitCycleCounter();
+		SCB->VTOR = (uint32_t)nvic_ram_vectors;
+		__DSB();
+		nvic_ram_vectors_active = true;
+	}
+
+	if((NVIC_PROFILE_NO_SLOT == nvic_profile_slot[interrupt_number]) &&
+	   (nvic_profile_slots_used < NVIC_PROFILE_MAX_IRQS))
+	{
+		slot = nvic_profile_slots_used++;
+		nvic_profile_handler[slot] = (nvic_handler_t)nvic_ram_vectors[NVIC_CORE_VECTORS + interrupt_number];
+		nvic_profile_probe[slot] = NULL;
+		NVIC_profile_clear(&nvic_profile[slot]);
+		nvic_profile_slot[interrupt_number] = slot;
+		nvic_ram_vectors[NVIC_CORE_VECTORS + interrupt_number] = (uint32_t)NVIC_profile_trampoline;
+		__DSB();
+	}
+	/**Out of slots: the IRQ keeps its own vector and is simply not profiled*/
+	__set_PRIMASK(primask);
+}
+#endif /* NVIC_PROFILE */
 
 void NVIC_enable_interrupt_and_priotity(interrupt_t interrupt_number, priority_level_t priority)
 {
+#if NVIC_PROFILE
+	NVIC_profile_install(interrupt_number);
+#endif
 	/**This functions are part of CMSIS Core functions*/
+	/**It Sets the priority of the IRQ first, so it can never fire at the reset priority*/
+	NVIC_SetPriority((IRQn_Type)interrupt_number, priority);
 	/**It enables the IRQ*/
-	NVIC_EnableIRQ(interrupt_number);
-	/**It Sets the priority of the IRQ*/
-	NVIC_SetPriority(interrupt_number, priority);
+	NVIC_EnableIRQ((IRQn_Type)interrupt_number);
 }
 
 
@@ -30,23 +201,87 @@ void NVIC_set_basepri_threshold(priority_level_t priority)
 }
 
 
+nvic_critical_t NVIC_enter_critical(priority_level_t ceiling)
+{
+	/**Keep the current mask so the caller can restore exactly what was there*/
+	nvic_critical_t saved = __get_BASEPRI();
+	/**BASEPRI_MAX only writes when the new level is more restrictive, which makes nesting safe*/
+	__set_BASEPRI_MAX(ceiling << (8 - __NVIC_PRIO_BITS));
+	return saved;
+}
+
+
+void NVIC_exit_critical(nvic_critical_t saved)
+{
+	__set_BASEPRI(saved);
+}
+
+
 void NVIC_init(void)
 {
+	uint8_t index;
+
 	/**Sets the threshold for interrupts, if the interrupt has higher priority constant that the BASEPRI, the interrupt will not be attended*/
-		NVIC_set_basepri_threshold(PRIORITY_10);
+	NVIC_set_basepri_threshold(NVIC_BASEPRI_THRESHOLD);
+
+	for(index = 0; index < (sizeof(nvic_irq_table) / sizeof(nvic_irq_table[0])); index++)
+	{
+		NVIC_enable_interrupt_and_priotity(nvic_irq_table[index].interrupt_number, nvic_irq_table[index].priority);
+	}
+
+	NVIC_global_enable_interrupts;
+}
+
 
-		NVIC_enable_interrupt_and_priotity(PORTA_IRQ, PRIORITY_3);
-		NVIC_enable_interrupt_and_priotity(PORTB_IRQ, PRIORITY_3);
-		NVIC_enable_interrupt_and_priotity(PORTC_IRQ, PRIORITY_4);
-		NVIC_enable_interrupt_and_priotity(PORTD_IRQ, PRIORITY_3);
-		NVIC_enable_interrupt_and_priotity(PORTE_IRQ, PRIORITY_3);
+#if NVIC_PROFILE
+bool NVIC_profile_get(interrupt_t interrupt_number, nvic_irq_profile_t *profile)
+{
+	uint32_t primask;
+	uint8_t slot;
+
+	if(!nvic_ram_vectors_active || (NVIC_PROFILE_NO_SLOT == nvic_profile_slot[interrupt_number]))
+	{
+		return false;
+	}
+	slot = nvic_profile_slot[interrupt_number];
+
+	/**The 64-bit sums are written by the handlers, copy them in one piece*/
+	primask = __get_PRIMASK();
+	__disable_irq();
+	*profile = nvic_profile[slot];
+	__set_PRIMASK(primask);
+	return true;
+}
 
-		NVIC_enable_interrupt_and_priotity(PIT_CH0_IRQ, PRIORITY_1);
-		NVIC_enable_interrupt_and_priotity(PIT_CH1_IRQ, PRIORITY_2);
-		NVIC_enable_interrupt_and_priotity(PIT_CH2_IRQ, PRIORITY_3);
-		NVIC_enable_interrupt_and_priotity(PIT_CH3_IRQ, PRIORITY_4);
 
-		NVIC_enable_interrupt_and_priotity(WDOG_OR_EWM_IRQ,PRIORITY_2);
+bool NVIC_profile_set_latency_probe(interrupt_t interrupt_number, nvic_latency_probe_t probe)
+{
+	if(!nvic_ram_vectors_active || (NVIC_PROFILE_NO_SLOT == nvic_profile_slot[interrupt_number]))
+	{
+		return false;
+	}
+	nvic_profile_probe[nvic_profile_slot[interrupt_number]] = probe;
+	return true;
+}
+
 
-		NVIC_global_enable_interrupts;
+void NVIC_profile_reset(void)
+{
+	uint32_t primask = __get_PRIMASK();
+	uint8_t slot;
+
+	__disable_irq();
+	for(slot = 0; slot < nvic_profile_slots_used; slot++)
+	{
+		NVIC_profile_clear(&nvic_profile[slot]);
+	}
+	nvic_max_depth = nvic_depth;
+	__set_PRIMASK(primask);
+}
+
+
+uint8_t NVIC_profile_max_depth(void)
+{
+	return nvic_max_depth;
 }
+#endif /* NVIC_PROFILE */
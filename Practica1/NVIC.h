@@ -14,11 +14,23 @@
 #define NVIC_H_
 
 #include <stdint.h>
+#include <stdbool.h>
 #include "MK64F12.h"
 
 #define NVIC_global_enable_interrupts __enable_irq()
 #define NVIC_disable_interrupts __disable_irq()
 
+/** Build option: 1 = every IRQ registered through NVIC_enable_interrupt_and_priotity() is
+ 	routed through a profiling trampoline (RAM vector table) that records call count,
+ 	exclusive duration, entry latency and preemptions with the DWT cycle counter. */
+#ifndef NVIC_PROFILE
+#define NVIC_PROFILE 0
+#endif
+/** Number of IRQs that can be profiled at the same time */
+#ifndef NVIC_PROFILE_MAX_IRQS
+#define NVIC_PROFILE_MAX_IRQS 8
+#endif
+
 /** enum type that defines the priority levels for the NVIC.
  * The highest priority is PRIORITY_0 and the lowest PRIORITY_15 */
 typedef enum {PRIORITY_0, PRIORITY_1, PRIORITY_2, PRIORITY_3, PRIORITY_4, PRIORITY_5, PRIORITY_6,
@@ -137,8 +149,128 @@ void NVIC_enable_interrupt_and_priotity(interrupt_t interrupt_number, priority_l
  	 \todo Implement a mechanism to clear interrupts by a specific pin.
  */
 void NVIC_set_basepri_threshold(priority_level_t priority);
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief	 Saved BASEPRI register value returned by NVIC_enter_critical().
+ */
+typedef uint32_t nvic_critical_t;
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief	 This function opens a critical section guarded by a priority ceiling.
+ 	 	 	 Every interrupt with priority equal or lower than the ceiling (numerically >=)
+ 	 	 	 is held off, interrupts above it keep running. BASEPRI is only ever raised,
+ 	 	 	 so sections nest: an inner section with a lower ceiling leaves the outer
+ 	 	 	 mask in place.
+
+ 	 \param[in] ceiling highest priority of any context that uses the shared resource.
+ 	 	 	 	 PRIORITY_0 cannot be masked through BASEPRI; use NVIC_disable_interrupts.
+ 	 \return previous BASEPRI value, to be handed to NVIC_exit_critical()
+ */
+nvic_critical_t NVIC_enter_critical(priority_level_t ceiling);
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief	 This function closes the critical section opened by the matching
+ 	 	 	 NVIC_enter_critical() by restoring the BASEPRI value it returned.
 
+ 	 \param[in] saved value returned by NVIC_enter_critical().
+ 	 \return void
+ */
+void NVIC_exit_critical(nvic_critical_t saved);
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief	 One row of the application interrupt table applied by NVIC_init().
+ */
+typedef struct
+{
+	interrupt_t interrupt_number;
+	priority_level_t priority;
+} nvic_irq_config_t;
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief	 This function applies the interrupt table of NVIC_config.h: every listed IRQ
+ 	 	 	 gets its priority and only then is enabled, IRQs not listed stay disabled.
+ 	 	 	 It also sets NVIC_BASEPRI_THRESHOLD and enables interrupts globally.
+ 	 	 	 The table is checked at build time for duplicated IRQs and out of range values.
+
+ 	 \return void
+ */
 void NVIC_init(void);
 
+#if NVIC_PROFILE
+/*!
+ 	 \brief	 Returns the core cycles between the interrupt request being raised and the
+ 	 	 	 moment it is called, read from the peripheral that raised it.
+ */
+typedef uint32_t (*nvic_latency_probe_t)(void);
+
+/*!
+ 	 \brief	 Profile of one IRQ, every time in core clock cycles.
+ */
+typedef struct
+{
+	uint32_t Count;				/**Handler invocations*/
+	uint32_t ExecMin;			/**Shortest run, time spent in nested handlers excluded*/
+	uint32_t ExecMax;			/**Longest run, nested handlers excluded*/
+	uint64_t ExecSum;
+	uint32_t LatencyMax;		/**Longest request to handler delay (needs a latency probe)*/
+	uint64_t LatencySum;
+	uint32_t LatencySamples;
+	uint32_t Preemptions;		/**Times a higher priority IRQ interrupted this handler*/
+	uint32_t StackMin;			/**Lowest MSP at handler entry: top of stack minus this is the
+									depth reached by this IRQ's priority level and those below*/
+} nvic_irq_profile_t;
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief	 This function copies the profile of an IRQ with interrupts briefly masked.
+
+ 	 \param[in] interrupt_number IRQ registered through NVIC_enable_interrupt_and_priotity().
+ 	 \param[out] profile destination of the snapshot.
+ 	 \return false if the IRQ is not being profiled
+ */
+bool NVIC_profile_get(interrupt_t interrupt_number, nvic_irq_profile_t *profile);
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief	 This function installs the entry latency probe of a profiled IRQ.
+
+ 	 \param[in] interrupt_number IRQ registered through NVIC_enable_interrupt_and_priotity().
+ 	 \param[in] probe function returning the cycles elapsed since the request, or NULL.
+ 	 \return false if the IRQ is not being profiled
+ */
+bool NVIC_profile_set_latency_probe(interrupt_t interrupt_number, nvic_latency_probe_t probe);
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief	 This function clears every profile and the nesting high-water mark.
+
+ 	 \return void
+ */
+void NVIC_profile_reset(void);
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief	 Deepest interrupt nesting seen by the profiler (1 = no nesting).
+
+ 	 \return nesting depth
+ */
+uint8_t NVIC_profile_max_depth(void);
+#endif
+
 
 #endif /* NVIC_H_ */
@@ -0,0 +1,86 @@
+/**
+	\file
+	\brief
+		Application interrupt table for NVIC_init().
+		Every IRQ the application services is listed here once with its priority;
+		IRQs that are not listed are never enabled. Rows depend on the same build
+		options as the modules that own the handlers.
+ */
+
+#ifndef NVIC_CONFIG_H_
+#define NVIC_CONFIG_H_
+
+#include "RMS.h"
+#include "ADC.h"
+#include "TELEMETRY.h"
+#include "HEALTH.h"
+#include "EVENT.h"
+
+/** BASEPRI applied by NVIC_init(). PRIORITY_0 leaves every priority unmasked, which the
+ 	preemptive scheduler needs because PendSV runs at the lowest priority. */
+#ifndef NVIC_BASEPRI_THRESHOLD
+#define NVIC_BASEPRI_THRESHOLD	PRIORITY_0
+#endif
+_Static_assert(!RMS_PREEMPTIVE || (NVIC_BASEPRI_THRESHOLD == PRIORITY_0),
+			   "a BASEPRI threshold would mask PendSV and stop the preemptive scheduler");
+
+/** Rows name the interrupt_t enumerator itself so the duplicate check can see it */
+#if ADC_USE_IRQ
+#define NVIC_ADC_IRQS(X)		X(ADC1_IRQ, ADC_IRQ_PRIORITY)
+#elif ADC_USE_DMA
+#define NVIC_ADC_IRQS(X)		X(DMA_CH0_IRQ, ADC_DMA_IRQ_PRIORITY)
+_Static_assert(ADC_DMA_IRQ == DMA_CH0_IRQ, "NVIC_ADC_IRQS must list ADC_DMA_IRQ");
+#else
+#define NVIC_ADC_IRQS(X)
+#endif
+
+#if RMS_TELEMETRY
+#define NVIC_TELEMETRY_IRQS(X)	X(DMA_CH1_IRQ, TELEMETRY_DMA_IRQ_PRIORITY)
+_Static_assert(TELEMETRY_DMA_IRQ == DMA_CH1_IRQ, "NVIC_TELEMETRY_IRQS must list TELEMETRY_DMA_IRQ");
+#else
+#define NVIC_TELEMETRY_IRQS(X)
+#endif
+
+#if HEALTH_MONITOR
+#define NVIC_HEALTH_IRQS(X)		X(WDOG_OR_EWM_IRQ, HEALTH_IRQ_PRIORITY)
+#else
+#define NVIC_HEALTH_IRQS(X)
+#endif
+
+#if RMS_SPORADIC
+#define NVIC_EVENT_IRQS(X)		X(PORTA_IRQ, EVENT_IRQ_PRIORITY) \
+								X(PORTC_IRQ, EVENT_IRQ_PRIORITY)
+_Static_assert(EVENT_IRQ_PRIORITY > RMS_CEILING_TICK, "RMS_SporadicPost() needs its caller below the tick ceiling");
+#else
+#define NVIC_EVENT_IRQS(X)
+#endif
+
+/** Hardware rate groups use one PIT channel per thread, channel 0 at the tick priority */
+#if RMS_HW_RATE_GROUPS >= 2
+#define NVIC_RMS_GROUP1_IRQS(X)	X(PIT_CH1_IRQ, RMS_RATE_GROUP_PRIORITY(1))
+#else
+#define NVIC_RMS_GROUP1_IRQS(X)
+#endif
+#if RMS_HW_RATE_GROUPS >= 3
+#define NVIC_RMS_GROUP2_IRQS(X)	X(PIT_CH2_IRQ, RMS_RATE_GROUP_PRIORITY(2))
+#else
+#define NVIC_RMS_GROUP2_IRQS(X)
+#endif
+#if RMS_HW_RATE_GROUPS >= 4
+#define NVIC_RMS_GROUP3_IRQS(X)	X(PIT_CH3_IRQ, RMS_RATE_GROUP_PRIORITY(3))
+#else
+#define NVIC_RMS_GROUP3_IRQS(X)
+#endif
+
+/** X(interrupt_t, priority_level_t) for every used IRQ */
+#define NVIC_IRQ_TABLE(X) \
+	X(PIT_CH0_IRQ, RMS_TICK_PRIORITY) \
+	NVIC_RMS_GROUP1_IRQS(X) \
+	NVIC_RMS_GROUP2_IRQS(X) \
+	NVIC_RMS_GROUP3_IRQS(X) \
+	NVIC_ADC_IRQS(X) \
+	NVIC_TELEMETRY_IRQS(X) \
+	NVIC_HEALTH_IRQS(X) \
+	NVIC_EVENT_IRQS(X)
+
+#endif /* NVIC_CONFIG_H_ */
@@ -0,0 +1,113 @@
+/**
+ * @file    POOL.c
+ *
+ * @brief Implementation of the fixed-block memory pools.
+ */
+
+#include "POOL.h"
+#include "fsl_debug_console.h"
+#include <stddef.h>
+
+/* Initialised pools, newest first */
+static pool_t *s_pools = NULL;
+
+/* Free-list links are block numbers plus one, so 0 can end the list */
+static inline uint32_t *POOL_Block(const pool_t *pool, uint32_t link){
+    return (uint32_t *)(void *)&pool->base[(link - 1U) * pool->blockSize];
+}
+
+/* Atomic add to a counter; returns the new value */
+static inline uint32_t POOL_AtomicAdd(volatile uint32_t *counter, uint32_t delta){
+    uint32_t value;
+
+    do{
+        value = __LDREXW(counter) + delta;
+    }while(__STREXW(value, counter) != 0U);
+    return value;
+}
+
+/* Raise the high-water mark to `value` unless it is already there */
+static inline void POOL_RaisePeak(pool_t *pool, uint32_t value){
+    do{
+        if (__LDREXW(&pool->peak) >= value){
+            __CLREX();
+            return;
+        }
+    }while(__STREXW(value, &pool->peak) != 0U);
+}
+
+bool POOL_Init(pool_t *pool, const char *name, void *storage, uint32_t blockSize, uint32_t blockCount){
+    uint32_t i;
+
+    if ((blockCount == 0U) || (((uintptr_t)storage & 3U) != 0U)){
+        return false;
+    }
+    pool->name       = name;
+    pool->base       = (uint8_t *)storage;
+    pool->blockSize  = POOL_BLOCK_BYTES(blockSize);
+    pool->blockCount = blockCount;
+    pool->inUse      = 0U;
+    pool->peak       = 0U;
+    pool->failures   = 0U;
+
+    /* Link every block to the next; the list starts at the lowest address */
+    for (i = 1U; i <= blockCount; i++){
+        *POOL_Block(pool, i) = (i < blockCount) ? (i + 1U) : 0U;
+    }
+    pool->freeHead = 1U;
+
+    pool->next = s_pools;
+    s_pools    = pool;
+    return true;
+}
+
+void *POOL_Alloc(pool_t *pool){
+    uint32_t head;
+
+    /* Pop the head. Reading its link inside the exclusive section is what makes this
+     * safe: a context that pops and pushes blocks meanwhile also fails the STREX. */
+    do{
+        head = __LDREXW(&pool->freeHead);
+        if (head == 0U){
+            __CLREX();
+            (void)POOL_AtomicAdd(&pool->failures, 1U);
+            return NULL;
+        }
+    }while(__STREXW(*POOL_Block(pool, head), &pool->freeHead) != 0U);
+
+    POOL_RaisePeak(pool, POOL_AtomicAdd(&pool->inUse, 1U));
+    return POOL_Block(pool, head);
+}
+
+bool POOL_Free(pool_t *pool, void *block){
+    uint32_t offset = (uint32_t)((uintptr_t)block - (uintptr_t)pool->base);
+    uint32_t head;
+
+    if (!POOL_Owns(pool, block) || ((offset % pool->blockSize) != 0U)){
+        return false;
+    }
+
+    /* Count the block out before it can be allocated again, so a context that takes it
+     * in between never sees more than blockCount in use */
+    (void)POOL_AtomicAdd(&pool->inUse, (uint32_t)-1);
+
+    /* Push: the link is written before the block is published as the new head */
+    do{
+        head = __LDREXW(&pool->freeHead);
+        *(uint32_t *)block = head;
+    }while(__STREXW((offset / pool->blockSize) + 1U, &pool->freeHead) != 0U);
+    return true;
+}
+
+void POOL_Report(void){
+    const pool_t *pool;
+    uint32_t total = 0U;
+
+    for (pool = s_pools; pool != NULL; pool = pool->next){
+        PRINTF("\r\nPOOL: %s %u x %u bytes, in use %u, peak %u, failed %u",
+               pool->name, (unsigned)pool->blockCount, (unsigned)pool->blockSize,
+               (unsigned)pool->inUse, (unsigned)pool->peak, (unsigned)pool->failures);
+        total += pool->blockCount * pool->blockSize;
+    }
+    PRINTF("\r\nPOOL: %u bytes reserved", (unsigned)total);
+}
@@ -0,0 +1,76 @@
+/**
+ * @file    POOL.h
+ *
+ * @brief Fixed-block memory pools with O(1), ISR-safe allocate and free.
+ *
+ * A pool hands out blocks of one size from static storage, so RAM use is fixed at
+ * build time and nothing ever fragments. Free blocks form a LIFO list threaded
+ * through their first word, linked by block number. Allocate and free are a single
+ * LDREX/STREX update of the list head: any exception taken in between clears the
+ * exclusive monitor and the update is retried, so threads and ISRs of any priority
+ * can share a pool without masking interrupts. Every pool tracks its high-water
+ * mark and its failed allocations, and all initialised pools can be listed with
+ * POOL_Report().
+ */
+
+#ifndef POOL_H_
+#define POOL_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "MK64F12.h"
+
+/* Bytes per block once rounded up to hold the free-list link, word aligned */
+#define POOL_BLOCK_BYTES(size)  ((((size) < 4U) ? 4U : ((size) + 3U)) & ~3U)
+
+/* Static storage for `count` blocks of `size` bytes, to pass to POOL_Init() */
+#define POOL_STORAGE(name, size, count) \
+    static uint32_t name[(POOL_BLOCK_BYTES(size) / 4U) * (count)]
+
+typedef struct pool_s {
+    const char       *name;         /* Label printed by POOL_Report() */
+    uint8_t          *base;         /* First block */
+    uint32_t          blockSize;    /* POOL_BLOCK_BYTES() of the requested size */
+    uint32_t          blockCount;
+    volatile uint32_t freeHead;     /* Number + 1 of the first free block, 0 when empty */
+    volatile uint32_t inUse;        /* Blocks currently allocated */
+    volatile uint32_t peak;         /* Highest inUse since init */
+    volatile uint32_t failures;     /* Allocations refused because the pool was empty */
+    struct pool_s    *next;         /* Registry of initialised pools */
+} pool_t;
+
+/* Carve word-aligned `storage` (from POOL_STORAGE) into `blockCount` blocks of
+ * `blockSize` bytes and register the pool. Returns false for misaligned storage or
+ * an empty pool. Call once, before any context uses the pool. */
+bool POOL_Init(pool_t *pool, const char *name, void *storage, uint32_t blockSize, uint32_t blockCount);
+
+/* One block, or NULL (and a failure counted) when the pool is exhausted.
+ * Contents are whatever the previous owner left. */
+void *POOL_Alloc(pool_t *pool);
+
+/* Give a block back. Returns false, and changes nothing, for a pointer that is not
+ * the start of one of this pool's blocks. Freeing a block twice is not detected. */
+bool POOL_Free(pool_t *pool, void *block);
+
+/* True when `p` points into this pool's storage. */
+static inline bool POOL_Owns(const pool_t *pool, const void *p){
+    return ((uintptr_t)p - (uintptr_t)pool->base) < (pool->blockSize * pool->blockCount);
+}
+
+static inline uint32_t POOL_GetInUse(const pool_t *pool){
+    return pool->inUse;
+}
+
+/* High-water mark: the most blocks ever allocated at once. */
+static inline uint32_t POOL_GetPeak(const pool_t *pool){
+    return pool->peak;
+}
+
+static inline uint32_t POOL_GetFailures(const pool_t *pool){
+    return pool->failures;
+}
+
+/* Print size, use and high-water mark of every initialised pool. */
+void POOL_Report(void);
+
+#endif /* POOL_H_ */
@@ -1,144 +1,1681 @@
-/*
- * Copyright (c) 2015, Freescale Semiconductor, Inc.
- * Copyright 2016-2019 NXP
- * All rights reserved.
- *
- * SPDX-License-Identifier: BSD-3-Clause
- */
-
-#include "fsl_debug_console.h"
-#include "pin_mux.h"
-#include "clock_config.h"
-#include "board.h"
-#include "fsl_pit.h"
-#include "RMS.h"
-
-/*******************************************************************************
- * Definitions
- ******************************************************************************/
-#define DEMO_PIT_BASEADDR PIT
-#define DEMO_PIT_CHANNEL  kPIT_Chnl_0
-#define PIT_LED_HANDLER   PIT0_IRQHandler
-#define PIT_IRQ_ID        PIT0_IRQn
-/* Get source clock for PIT driver */
-#define PIT_SOURCE_CLOCK CLOCK_GetFreq(kCLOCK_BusClk)
-#define LED_INIT()       LED_RED_INIT(LOGIC_LED_ON)
-#define LED_TOGGLE()     LED_RED_TOGGLE()
-
-/*******************************************************************************
- * Prototypes
- ******************************************************************************/
-
-void Thd_2ms(void);
-void Thd_5ms(void);
-void Thd_10ms(void);
-void Thd_idle(void);
-
-/*******************************************************************************
- * Variables
- ******************************************************************************/
-
-volatile bool pitIsrFlag = false;
-
-ThdObj ThreadTable[] = {
-		{Thd_2ms, STANDBY, 2, 0},
-		{Thd_5ms, STANDBY, 5, 0},
-		{Thd_10ms, STANDBY, 10, 0},
-};
-
-/*******************************************************************************
- * Code
- ******************************************************************************/
-void PIT_LED_HANDLER(void)
-{
-    static uint8_t tableCounter = 0;
-
-	/* Clear interrupt flag.*/
-    PIT_ClearStatusFlags(DEMO_PIT_BASEADDR, DEMO_PIT_CHANNEL, kPIT_TimerFlag);
-    pitIsrFlag = true;
-    /* Added for, and affects, all PIT handlers. For CPU clock which is much larger than the IP bus clock,
-     * CPU can run out of the interrupt handler before the interrupt flag being cleared, resulting in the
-     * CPU's entering the handler again and again. Adding DSB can prevent the issue from happening.
-     */
-
-    for(tableCounter=0;tableCounter<3;tableCounter++){
-    	ThreadTable[tableCounter].SystemTime++;
-    	if(ThreadTable[tableCounter].SystemTime>=ThreadTable[tableCounter].ThreadRate){
-    		ThreadTable[tableCounter].ThreadState = READY;
-    		ThreadTable[tableCounter].SystemTime = 0;
-    	}
-    }
-
-    __DSB();
-}
-
-/*!
- * @brief Main function
- */
-int main(void)
-{
-    uint8_t tableCounter;
-
-	/* Structure of initialize PIT */
-    pit_config_t pitConfig;
-
-    /* Board pin, clock, debug console init */
-    BOARD_InitBootPins();
-    BOARD_InitBootClocks();
-    BOARD_InitDebugConsole();
-
-    /* Initialize and enable LED */
-    LED_INIT();
-
-    /*
-     * pitConfig.enableRunInDebug = false;
-     */
-    PIT_GetDefaultConfig(&pitConfig);
-
-    /* Init pit module */
-    PIT_Init(DEMO_PIT_BASEADDR, &pitConfig);
-
-    /* Set timer period for channel 0 */
-    PIT_SetTimerPeriod(DEMO_PIT_BASEADDR, DEMO_PIT_CHANNEL, USEC_TO_COUNT(1000U, PIT_SOURCE_CLOCK));
-
-    /* Enable timer interrupts for channel 0 */
-    PIT_EnableInterrupts(DEMO_PIT_BASEADDR, DEMO_PIT_CHANNEL, kPIT_TimerInterruptEnable);
-
-    /* Enable at the NVIC */
-    EnableIRQ(PIT_IRQ_ID);
-
-    /* Start channel 0 */
-    PRINTF("\r\nStarting channel No.0 ...");
-    PIT_StartTimer(DEMO_PIT_BASEADDR, DEMO_PIT_CHANNEL);
-
-    while (true)
-    {
-        for(tableCounter=0;tableCounter<3;tableCounter++){
-        	if(ThreadTable[tableCounter].ThreadState == READY){
-        		ThreadTable[tableCounter].ThreadState = EXECUTE;
-        		ThreadTable[tableCounter].ThreadHandler();
-        		ThreadTable[tableCounter].ThreadState = STANDBY;
-        	}
-        	else{
-        		Thd_idle();
-        	}
-        }
-    }
-}
-
-void Thd_2ms(void){
-	volatile static uint8_t counter = 0;
-	counter++;
-}
-
-void Thd_5ms(void){
-	volatile static uint8_t counter = 0;
-	counter++;
-}
-
-void Thd_10ms(void){
-	volatile static uint8_t counter = 0;
-	counter++;
-}
-
-void Thd_idle(void){}
+/*
+ * Copyright (c) 2015, Freescale Semiconductor, Inc.
+ * Copyright 2016-2019 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "fsl_debug_console.h"
+#include "pin_mux.h"
+#include "clock_config.h"
+#include "board.h"
+#include "fsl_pit.h"
+#include <string.h>
+#include <math.h>
+#include "RMS.h"
+#include "ADC.h"
+#include "NVIC.h"
+#if RMS_STATS
+#include "DWT.h"
+#endif
+#if RMS_TELEMETRY
+#include "TELEMETRY.h"
+#endif
+#if RMS_BENCH
+#include "BENCH.h"
+#endif
+#include "CRASH.h"
+#include "RTT.h"
+#include "HEALTH.h"
+#include "STACK.h"
+#if RMS_ADC_ADAPTIVE && ADC_USE_DMA
+#error "RMS_ADC_ADAPTIVE: DMA sampling costs the thread no conversion time to adapt"
+#endif
+#if RMS_SPORADIC
+#include "EVENT.h"
+#endif
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+#define DEMO_PIT_BASEADDR PIT
+#define DEMO_PIT_CHANNEL  kPIT_Chnl_0
+#define PIT_LED_HANDLER   PIT0_IRQHandler
+#define PIT_IRQ_ID        PIT0_IRQn
+/* Get source clock for PIT driver */
+#define PIT_SOURCE_CLOCK CLOCK_GetFreq(kCLOCK_BusClk)
+#define LED_INIT()       LED_RED_INIT(LOGIC_LED_ON)
+#define LED_TOGGLE()     LED_RED_TOGGLE()
+/* Number of entries in ThreadTable */
+#define RMS_THREAD_NUM   (sizeof(ThreadTable) / sizeof(ThreadTable[0]))
+/* ThreadTable index of Thd_10ms, the ADC thread: the slowest rate comes last */
+#define RMS_ADC_THREAD   (RMS_THREAD_NUM - 1U)
+
+#if RMS_MIXED_CRIT
+/* Sensor alarm: Thd_10ms holds RMS_MODE_OVERLOAD from this average temperature on,
+ * until it is RMS_TEMP_ALARM_HYST_DECI below it again (tenths of °C) */
+#define RMS_TEMP_ALARM_DECI       350U
+#define RMS_TEMP_ALARM_HYST_DECI  20U
+#define RMS_TABLE_MODES           RMS_MODE_COUNT
+#define RMS_ACTIVE_MODE           ActiveMode
+#else
+#define RMS_TABLE_MODES           1U
+#define RMS_ACTIVE_MODE           RMS_MODE_NORMAL
+#endif
+
+#if RMS_PREEMPTIVE
+/* Initial stack frame: R3-R11 and EXC_RETURN saved by PendSV, then the hardware
+ * exception frame R0-R3, R12, LR, PC, xPSR */
+#define RMS_SW_FRAME_WORDS     10U
+#define RMS_HW_FRAME_WORDS     8U
+#define RMS_HW_FRAME_R0        0U
+#define RMS_HW_FRAME_LR        5U
+#define RMS_HW_FRAME_PC        6U
+#define RMS_HW_FRAME_XPSR      7U
+#define RMS_INITIAL_XPSR       0x01000000UL   /* Thumb bit */
+#define RMS_EXC_RETURN_PSP     0xFFFFFFFDUL   /* Thread mode, PSP, no FPU frame */
+#define RMS_PENDSV_PRIORITY    ((1UL << __NVIC_PRIO_BITS) - 1UL)
+
+#if defined(__FPU_USED) && (__FPU_USED == 1U)
+/* EXC_RETURN bit 4 clear: the preempted context owns an extended (FPU) frame */
+#define RMS_FPU_PUSH        "TST     LR, #0x10           \n" \
+                            "IT      EQ                  \n" \
+                            "VPUSHEQ {S16-S31}           \n"
+#define RMS_FPU_SAVE        "TST     LR, #0x10           \n" \
+                            "IT      EQ                  \n" \
+                            "VSTMDBEQ R0!, {S16-S31}     \n"
+#define RMS_FPU_RESTORE     "TST     LR, #0x10           \n" \
+                            "IT      EQ                  \n" \
+                            "VLDMIAEQ R0!, {S16-S31}     \n"
+#else
+#define RMS_FPU_PUSH        ""
+#define RMS_FPU_SAVE        ""
+#define RMS_FPU_RESTORE     ""
+#endif
+#endif /* RMS_PREEMPTIVE */
+
+#if RMS_STATS
+#define RMS_STATS_RELEASE(idx, now)  (ThreadStats[(idx)].ReleaseCycle = (now))
+#define RMS_STATS_JOB_START(idx)     RMS_StatsJobStart(idx)
+#define RMS_STATS_JOB_END(idx)       RMS_StatsJobEnd(idx)
+#else
+#define RMS_STATS_RELEASE(idx, now)  ((void)0)
+#define RMS_STATS_JOB_START(idx)     ((void)0)
+#define RMS_STATS_JOB_END(idx)       ((void)0)
+#endif
+
+#if HEALTH_MONITOR
+#define RMS_HEALTH_CHECKIN(idx)      HEALTH_CheckIn((idx), SystemTick)
+#define RMS_HEALTH_SUPERVISE()       HEALTH_Supervise(SystemTick)
+#else
+#define RMS_HEALTH_CHECKIN(idx)      ((void)0)
+#define RMS_HEALTH_SUPERVISE()       ((void)0)
+#endif
+
+#if RMS_SPORADIC
+#define RMS_SPORADIC_ACTIVATE(idx)   RMS_SporadicActivate(idx)
+#define RMS_IS_SERVER(idx)           (ThreadTable[(idx)].ServerBudgetUs != 0U)
+#else
+#define RMS_SPORADIC_ACTIVATE(idx)   (false)
+#define RMS_IS_SERVER(idx)           (false)
+#endif
+
+#if STACK_MONITOR
+#define RMS_STACK_SCAN()             STACK_Scan(SystemTick)
+#else
+#define RMS_STACK_SCAN()             ((void)0)
+#endif
+
+#if RMS_MIXED_CRIT
+#define RMS_MODE_MISS(idx)           RMS_ModeMiss(idx)
+#else
+#define RMS_MODE_MISS(idx)           ((void)0)
+#endif
+
+#if RMS_BENCH
+#define RMS_BENCH_STAMP(point)       BENCH_Stamp(point)
+#else
+#define RMS_BENCH_STAMP(point)       ((void)0)
+#endif
+
+/*******************************************************************************
+ * Prototypes
+ ******************************************************************************/
+
+void Thd_2ms(void);
+void Thd_5ms(void);
+void Thd_10ms(void);
+void Thd_idle(void);
+#if RMS_SPORADIC
+void Thd_events(void);
+#endif
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+
+volatile bool pitIsrFlag = false;
+
+/* Rate-monotonic order: shortest ThreadRate (highest priority) first */
+ThdObj ThreadTable[] = {
+		{.ThreadHandler = Thd_2ms,  .ThreadState = STANDBY, .ThreadRate = 2,  .ThreadWcetUs = 200,  .MissPolicy = RMS_MISS_SKIP},
+#if RMS_SPORADIC
+		/* Sporadic server for the button events: two 100 us activations per 4 ticks */
+		{.ThreadHandler = Thd_events, .ThreadState = STANDBY, .ThreadRate = 4, .ThreadWcetUs = 100, .ServerBudgetUs = 200},
+#endif
+		/* Low criticality: shed in RMS_MODE_OVERLOAD */
+		{.ThreadHandler = Thd_5ms,  .ThreadState = STANDBY, .ThreadRate = 5,  .ThreadWcetUs = 500,  .MissPolicy = RMS_MISS_SKIP,
+		 .OverloadRate = RMS_RATE_SHED},
+		/* Slowed in RMS_MODE_OVERLOAD, it still watches the temperature alarm */
+		{.ThreadHandler = Thd_10ms, .ThreadState = STANDBY, .ThreadRate = 10, .ThreadWcetUs = 1000, .MissPolicy = RMS_MISS_DEGRADE,
+		 .OverloadRate = 20},
+};
+
+/* Ready set: bit RMS_READY_BIT(i) is set while ThreadTable[i] is READY */
+volatile uint32_t ThreadReadyMask = 0U;
+
+#if RMS_SPORADIC
+/* ThreadTable index of Thd_events */
+#define RMS_EVENT_THREAD        1U
+
+/* Budget given back to a sporadic server at a later tick */
+typedef struct{
+    uint32_t Tick;      /* SystemTick at which AmountUs returns to BudgetUs */
+    uint32_t AmountUs;
+}RmsReplenish;
+
+/* Per-server FIFO of pending replenishments; charged in release order, so each
+ * queue is sorted by Tick. Only touched under RMS_CEILING_TICK. */
+static RmsReplenish ReplenishQueue[RMS_MAX_THREADS][RMS_SPORADIC_REPLENISH_MAX];
+static uint8_t ReplenishHead[RMS_MAX_THREADS];
+static uint8_t ReplenishCount[RMS_MAX_THREADS];
+
+/* Servers with a pending replenishment (RMS_READY_BIT layout) and the earliest due tick */
+static uint32_t ReplenishMask;
+static uint32_t ReplenishNextTick;
+#endif
+
+#if !RMS_HW_RATE_GROUPS
+/* Per-thread FIFO of the release ticks of queued late jobs; ThdObj.LateJobs is the
+ * count. A late job is measured from its own release, not its predecessor's. Only
+ * touched under RMS_CEILING_TICK. */
+static uint32_t LateReleaseTick[RMS_MAX_THREADS][RMS_MAX_LATE_JOBS];
+static uint8_t LateHead[RMS_MAX_THREADS];
+#endif
+
+_Static_assert(RMS_THREAD_NUM <= RMS_MAX_THREADS, "ThreadTable exceeds the ready bitmap width");
+#if RMS_HW_RATE_GROUPS
+_Static_assert(RMS_THREAD_NUM == RMS_HW_RATE_GROUPS, "RMS_HW_RATE_GROUPS must match ThreadTable");
+#endif
+
+#if !RMS_HW_RATE_GROUPS
+/* One instant of the hyperperiod release schedule */
+typedef struct{
+    uint32_t Delay;     /* Ticks since the previous entry */
+    uint32_t Mask;      /* Threads released at this instant (RMS_READY_BIT layout) */
+}RlsEntry;
+
+/* Static cyclic release schedule of every mode, built once by RMS_BuildReleaseTable(),
+ * and the one the tick walks. A count of 0 marks a mode whose hyperperiod has more
+ * instants than RMS_RELEASE_TABLE_SIZE: it runs on per-thread countdowns instead. */
+static RlsEntry ReleaseTables[RMS_TABLE_MODES][RMS_RELEASE_TABLE_SIZE];
+static uint32_t ReleaseCounts[RMS_TABLE_MODES];
+static uint32_t ReleaseMasks[RMS_TABLE_MODES];  /* Threads a mode's schedule releases */
+static const RlsEntry *ReleaseTable;
+static uint32_t ReleaseCount;
+static uint32_t ReleaseIndex;
+static uint32_t ReleaseCountdown;
+
+/* Countdown schedule: ticks from the previous release instant to each thread's next
+ * release, and the spacing of the instant ReleaseCountdown counts down to */
+static uint32_t ReleaseLeft[RMS_THREAD_NUM];
+static uint32_t ReleaseStep;
+#endif
+
+#if RMS_MIXED_CRIT
+/* Mode of ReleaseTable, the one asked for by RMS_RequestMode(), and the hyperperiods
+ * a miss still holds RMS_MODE_OVERLOAD for. Switched only by the tick. */
+static volatile uint8_t ActiveMode = RMS_MODE_NORMAL;
+static volatile uint8_t RequestedMode = RMS_MODE_NORMAL;
+static uint32_t ModeHoldPeriods;
+static uint32_t ModeSwitches;
+#endif
+
+/* Monotonic scheduler time in ticks */
+static volatile uint32_t SystemTick;
+
+#if RMS_TICKLESS
+/* PIT counts in one scheduler tick */
+static uint32_t PitTickCounts;
+
+/* Ticks the PIT currently counts per interrupt */
+static uint32_t ProgrammedTicks = 1U;
+#endif
+
+/* Worst-case response times from RMS_CheckSchedulability() */
+static uint32_t ThreadResponseUs[RMS_THREAD_NUM];
+
+_Static_assert(RMS_THREAD_NUM > 0U, "ThreadTable is empty");
+
+#if RMS_PREEMPTIVE
+/* One private stack per thread, 8-byte aligned as required by AAPCS, or on the
+ * SYSMPU granularity when its lowest STACK_GUARD_BYTES are a guard */
+#if STACK_GUARD
+_Static_assert(((RMS_THREAD_STACK_WORDS * 4U) % STACK_GUARD_BYTES) == 0U, "guards must stay aligned");
+static uint32_t ThreadStack[RMS_THREAD_NUM][RMS_THREAD_STACK_WORDS] __attribute__((aligned(STACK_GUARD_BYTES)));
+#else
+static uint32_t ThreadStack[RMS_THREAD_NUM][RMS_THREAD_STACK_WORDS] __attribute__((aligned(8)));
+#endif
+
+/* Saved stack pointer of the idle context, which keeps running on MSP */
+static uint32_t IdleStackPointer;
+#endif
+
+/* ThreadTable index owning the CPU, RMS_IDLE_INDEX while idle */
+volatile uint32_t RunningThread = RMS_IDLE_INDEX;
+
+#if RMS_STATS
+ThdStats ThreadStats[RMS_THREAD_NUM];
+
+/* Length of one PIT tick in core cycles, used to turn ThreadRate into a deadline */
+static uint32_t TickCycles;
+#endif
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+/* Atomically set bits in the ready set. Any exception taken between LDREX and STREX
+ * clears the exclusive monitor, so the update is retried instead of being lost. */
+static inline void RMS_ReadySet(uint32_t mask)
+{
+    uint32_t ready;
+
+    do{
+        ready = __LDREXW(&ThreadReadyMask);
+    }while(__STREXW(ready | mask, &ThreadReadyMask) != 0U);
+}
+
+/* Atomically clear bits in the ready set. */
+static inline void RMS_ReadyClear(uint32_t mask)
+{
+    uint32_t ready;
+
+    do{
+        ready = __LDREXW(&ThreadReadyMask);
+    }while(__STREXW(ready & ~mask, &ThreadReadyMask) != 0U);
+}
+
+/* Period of ThreadTable[index] in a mode (ticks), 0 = not released in that mode.
+ * Sporadic servers ignore the mode: their budget already bounds them. */
+static inline uint32_t RMS_ModeRate(uint32_t index, uint32_t mode)
+{
+    uint32_t rate = ThreadTable[index].ThreadRate;
+
+    if((mode == RMS_MODE_OVERLOAD) && (ThreadTable[index].OverloadRate != 0U) && !RMS_IS_SERVER(index)){
+        rate = (ThreadTable[index].OverloadRate == RMS_RATE_SHED) ? 0U : ThreadTable[index].OverloadRate;
+    }
+    return rate;
+}
+
+#if RMS_STATS
+static void RMS_StatsInit(void)
+{
+    uint8_t index;
+
+    DWT_InitCycleCounter();
+    TickCycles = (uint32_t)USEC_TO_COUNT(RMS_TICK_US, SystemCoreClock);
+
+    memset(ThreadStats, 0, sizeof(ThreadStats));
+    for(index=0;index<RMS_THREAD_NUM;index++){
+        ThreadStats[index].ExecMin    = UINT32_MAX;
+        ThreadStats[index].LatencyMin = UINT32_MAX;
+    }
+}
+
+static inline void RMS_StatsJobStart(uint32_t index)
+{
+    ThdStats *stats = &ThreadStats[index];
+    uint32_t latency;
+    uint32_t rate;
+    nvic_critical_t crit;
+
+    stats->StartCycle = DWT_GetCycles();
+    latency = stats->StartCycle - stats->ReleaseCycle;
+
+    crit = NVIC_enter_critical(RMS_CEILING_SCHED);
+    if(latency < stats->LatencyMin){ stats->LatencyMin = latency; }
+    if(latency > stats->LatencyMax){ stats->LatencyMax = latency; }
+    stats->LatencySum += latency;
+    NVIC_exit_critical(crit);
+
+    /* Deadline is the next release: one period of the current mode after this job's
+     * release. A job left over from before its thread was shed keeps ThreadRate. */
+    rate = RMS_ModeRate(index, RMS_ACTIVE_MODE);
+    if(rate == 0U){ rate = ThreadTable[index].ThreadRate; }
+    stats->DeadlineCycle = stats->ReleaseCycle + (rate * TickCycles);
+}
+
+static inline void RMS_StatsJobEnd(uint32_t index)
+{
+    ThdStats *stats = &ThreadStats[index];
+    uint32_t end = DWT_GetCycles();
+    uint32_t exec = end - stats->StartCycle;
+    nvic_critical_t crit;
+
+    /* Readers in other threads must not see ExecSum and Jobs from different jobs */
+    crit = NVIC_enter_critical(RMS_CEILING_SCHED);
+    if(exec < stats->ExecMin){ stats->ExecMin = exec; }
+    if(exec > stats->ExecMax){ stats->ExecMax = exec; }
+    stats->ExecSum += exec;
+    stats->Jobs++;
+
+    if((int32_t)(end - stats->DeadlineCycle) > 0){
+        stats->Overruns++;
+    }
+    NVIC_exit_critical(crit);
+}
+
+uint32_t RMS_GetAvgExecCycles(uint8_t index)
+{
+    const ThdStats *stats = &ThreadStats[index];
+    nvic_critical_t crit = NVIC_enter_critical(RMS_CEILING_SCHED);
+    uint32_t avg = (stats->Jobs == 0U) ? 0U : (uint32_t)(stats->ExecSum / stats->Jobs);
+
+    NVIC_exit_critical(crit);
+    return avg;
+}
+
+uint32_t RMS_GetAvgLatencyCycles(uint8_t index)
+{
+    const ThdStats *stats = &ThreadStats[index];
+    nvic_critical_t crit = NVIC_enter_critical(RMS_CEILING_SCHED);
+    uint32_t avg = (stats->Jobs == 0U) ? 0U : (uint32_t)(stats->LatencySum / stats->Jobs);
+
+    NVIC_exit_critical(crit);
+    return avg;
+}
+
+uint32_t RMS_GetJobSlackUs(uint8_t index)
+{
+    uint32_t elapsed = DWT_GetCycles() - ThreadStats[index].StartCycle;
+    uint32_t budget = (uint32_t)USEC_TO_COUNT(ThreadTable[index].ThreadWcetUs, SystemCoreClock);
+
+    return (elapsed < budget) ? (uint32_t)COUNT_TO_USEC(budget - elapsed, SystemCoreClock) : 0U;
+}
+
+uint32_t RMS_CheckBudgets(void)
+{
+    uint32_t over = 0U;
+    uint8_t index;
+
+    for(index=0;index<RMS_THREAD_NUM;index++){
+        uint32_t budget = (uint32_t)USEC_TO_COUNT(ThreadTable[index].ThreadWcetUs, SystemCoreClock);
+        if((ThreadStats[index].Jobs != 0U) && (ThreadStats[index].ExecMax > budget)){
+            over |= RMS_READY_BIT(index);
+        }
+    }
+    return over;
+}
+#endif /* RMS_STATS */
+
+/* Cost of ThreadTable[index] per ThreadRate ticks as seen by the analysis: a
+ * sporadic server can use at most its whole budget in every replenishment period. */
+static inline uint32_t RMS_AnalysisCostUs(uint32_t index)
+{
+    return RMS_IS_SERVER(index) ? ThreadTable[index].ServerBudgetUs : ThreadTable[index].ThreadWcetUs;
+}
+
+#if !RMS_PREEMPTIVE && !RMS_HW_RATE_GROUPS
+/* Blocking B_i of cooperative dispatch: the longest job of a lower-priority thread the
+ * mode keeps, which may have started just before ThreadTable[index] is released. */
+static uint32_t RMS_BlockingUs(uint32_t index, uint32_t mode)
+{
+    uint32_t blocking = 0U;
+    uint32_t k;
+
+    for(k=index+1U;k<RMS_THREAD_NUM;k++){
+        if((RMS_ModeRate(k, mode) != 0U) && (ThreadTable[k].ThreadWcetUs > blocking)){
+            blocking = ThreadTable[k].ThreadWcetUs;
+        }
+    }
+    return blocking;
+}
+#endif
+
+/* Analysis of one mode; threads it sheds are left out. Response times are merged
+ * into ThreadResponseUs as a maximum over the modes. */
+static uint8_t RMS_CheckMode(uint32_t mode)
+{
+    uint8_t result = RMS_SCHEDULABLE;
+    uint32_t utilizationPpm = 0U;
+    uint32_t boundPpm;
+    uint32_t active = 0U;
+    uint8_t i, j;
+
+    for(i=0;i<RMS_THREAD_NUM;i++){
+        uint32_t periodUs = RMS_ModeRate(i, mode) * RMS_TICK_US;
+        uint32_t blocking = 0U;
+        uint32_t response;
+        uint32_t previous = 0U;
+
+        if(periodUs == 0U){
+            continue;
+        }
+#if !RMS_PREEMPTIVE && !RMS_HW_RATE_GROUPS
+        blocking = RMS_BlockingUs(i, mode);
+#endif
+        response = blocking + RMS_AnalysisCostUs(i);
+        active++;
+        utilizationPpm += (uint32_t)(((uint64_t)RMS_AnalysisCostUs(i) * 1000000U) / periodUs);
+
+        /* Priorities follow table order, which must also be rate order for RMS. The
+         * overload mode keeps those priorities, so only its response times count. */
+        if((mode == RMS_MODE_NORMAL) && (i > 0U) && (ThreadTable[i].ThreadRate < ThreadTable[i-1U].ThreadRate)){
+            PRINTF("\r\nRMS: thread %u is faster than a higher-priority thread", i);
+            if(result == RMS_SCHEDULABLE){ result = i; }
+        }
+        if((mode == RMS_MODE_OVERLOAD) && (RMS_ModeRate(i, mode) < ThreadTable[i].ThreadRate)){
+            PRINTF("\r\nRMS: thread %u runs faster in overload", i);
+            if(result == RMS_SCHEDULABLE){ result = i; }
+        }
+
+        /* Exact response time: R = B_i + C_i + sum_{j<i} ceil(R / T_j) * C_j, iterated to a
+         * fixed point. B_i is 0 when higher priorities preempt. */
+        while((response != previous) && (response <= periodUs)){
+            previous = response;
+            response = blocking + RMS_AnalysisCostUs(i);
+            for(j=0;j<i;j++){
+                uint32_t periodJ = RMS_ModeRate(j, mode) * RMS_TICK_US;
+
+                if(periodJ != 0U){
+                    response += ((previous + periodJ - 1U) / periodJ) * RMS_AnalysisCostUs(j);
+                }
+            }
+        }
+        if(response > ThreadResponseUs[i]){
+            ThreadResponseUs[i] = response;
+        }
+
+        PRINTF("\r\nRMS: thread %u T=%u us C=%u us B=%u us R=%u us%s", i, periodUs,
+               RMS_AnalysisCostUs(i), blocking, response, (response > periodUs) ? " DEADLINE MISS" : "");
+        if((response > periodUs) && (result == RMS_SCHEDULABLE)){
+            result = i;
+        }
+
+#if RMS_SPORADIC
+        /* A server must afford at least one activation, and every activation it can
+         * afford in one period needs a replenishment slot */
+        if(RMS_IS_SERVER(i) &&
+           ((ThreadTable[i].ThreadWcetUs == 0U) ||
+            (ThreadTable[i].ServerBudgetUs < ThreadTable[i].ThreadWcetUs) ||
+            ((ThreadTable[i].ServerBudgetUs / ThreadTable[i].ThreadWcetUs) > RMS_SPORADIC_REPLENISH_MAX))){
+            PRINTF("\r\nRMS: server %u needs 1..%u activations of C per budget", i, RMS_SPORADIC_REPLENISH_MAX);
+            if(result == RMS_SCHEDULABLE){ result = i; }
+        }
+#endif
+    }
+
+    /* Liu & Layland: U <= n(2^(1/n) - 1) is sufficient; above it only the exact test decides */
+    boundPpm = (active == 0U) ? 0U :
+               (uint32_t)(1000000.0f * (float)active * (powf(2.0f, 1.0f / (float)active) - 1.0f));
+    PRINTF("\r\nRMS: U=%u ppm, Liu-Layland bound=%u ppm", utilizationPpm, boundPpm);
+
+    return result;
+}
+
+#if !RMS_HW_RATE_GROUPS
+/* Release schedule built for a mode by RMS_BuildReleaseTable(); its entries add up to
+ * the hyperperiod */
+static void RMS_ReportReleaseTable(uint32_t mode)
+{
+    uint32_t hyperperiod = 0U;
+    uint32_t i;
+
+    if(ReleaseCounts[mode] == 0U){
+        PRINTF("\r\nRMS: hyperperiod over %u release instants, per-thread countdowns", RMS_RELEASE_TABLE_SIZE);
+        return;
+    }
+    for(i=0;i<ReleaseCounts[mode];i++){
+        hyperperiod += ReleaseTables[mode][i].Delay;
+    }
+    PRINTF("\r\nRMS: hyperperiod %u ticks, %u release instants", hyperperiod, ReleaseCounts[mode]);
+}
+#endif
+
+uint8_t RMS_CheckSchedulability(void)
+{
+    uint8_t result = RMS_SCHEDULABLE;
+    uint32_t mode;
+
+    memset(ThreadResponseUs, 0, sizeof(ThreadResponseUs));
+    for(mode=0U;mode<RMS_TABLE_MODES;mode++){
+        uint8_t first;
+
+        /* One block per mode: its release schedule, then its analysis */
+#if RMS_MIXED_CRIT
+        PRINTF("\r\nRMS: mode %u", mode);
+#endif
+#if !RMS_HW_RATE_GROUPS
+        RMS_ReportReleaseTable(mode);
+#endif
+        first = RMS_CheckMode(mode);
+
+        if(result == RMS_SCHEDULABLE){
+            result = first;
+        }
+    }
+    return result;
+}
+
+uint32_t RMS_GetResponseTimeUs(uint8_t index)
+{
+    return ThreadResponseUs[index];
+}
+
+#if !RMS_HW_RATE_GROUPS
+static uint32_t RMS_Gcd(uint32_t a, uint32_t b)
+{
+    while(b != 0U){
+        uint32_t t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+/* Start the release schedule of a mode at one of its hyperperiod instants, where all of
+ * its threads have just been released together. */
+static void RMS_ScheduleStart(uint32_t mode)
+{
+    uint8_t i;
+
+    ReleaseTable = ReleaseTables[mode];
+    ReleaseCount = ReleaseCounts[mode];
+    ReleaseIndex = 0U;
+    if(ReleaseCount != 0U){
+        ReleaseCountdown = ReleaseTable[0].Delay;
+        return;
+    }
+
+    ReleaseCountdown = UINT32_MAX;
+    for(i=0;i<RMS_THREAD_NUM;i++){
+        ReleaseLeft[i] = UINT32_MAX;
+        if((ReleaseMasks[mode] & RMS_READY_BIT(i)) != 0U){
+            ReleaseLeft[i] = RMS_ModeRate(i, mode);
+            if(ReleaseLeft[i] < ReleaseCountdown){
+                ReleaseCountdown = ReleaseLeft[i];
+            }
+        }
+    }
+    ReleaseStep = ReleaseCountdown;
+}
+
+/* Expand ThreadTable into the list of release instants of one hyperperiod of a mode,
+ * so the tick only has to count down to the next entry instead of updating every
+ * thread. The last entry is the hyperperiod instant itself and releases every thread
+ * of the mode. The table of RMS_MODE_NORMAL is the one started with. */
+static bool RMS_BuildReleaseTable(uint32_t mode)
+{
+    RlsEntry *table = ReleaseTables[mode];
+    uint32_t nextRelease[RMS_THREAD_NUM];
+    uint32_t rate[RMS_THREAD_NUM];
+    uint64_t hyperperiod = 1U;
+    uint32_t mask = 0U;
+    uint32_t count = 0U;
+    uint32_t now = 0U;
+    uint8_t i;
+
+    for(i=0;i<RMS_THREAD_NUM;i++){
+        if(ThreadTable[i].ThreadRate == 0U){
+            return false;
+        }
+        rate[i] = RMS_ModeRate(i, mode);
+        if(RMS_IS_SERVER(i) || (rate[i] == 0U)){
+            /* Released by events, or shed by this mode: never by the table */
+            nextRelease[i] = UINT32_MAX;
+            continue;
+        }
+        mask |= RMS_READY_BIT(i);
+        nextRelease[i] = rate[i];
+        if(hyperperiod <= UINT32_MAX){
+            hyperperiod = (hyperperiod / RMS_Gcd((uint32_t)hyperperiod, rate[i])) * rate[i];
+        }
+    }
+    if(mask == 0U){
+        return false; /* Only sporadic servers: nothing drives the tick */
+    }
+    ReleaseMasks[mode] = mask;
+
+    while((hyperperiod <= UINT32_MAX) && (now < (uint32_t)hyperperiod)){
+        uint32_t earliest = UINT32_MAX;
+
+        if(count >= RMS_RELEASE_TABLE_SIZE){
+            break;
+        }
+        for(i=0;i<RMS_THREAD_NUM;i++){
+            if(nextRelease[i] < earliest){
+                earliest = nextRelease[i];
+            }
+        }
+        table[count].Delay = earliest - now;
+        table[count].Mask  = 0U;
+        for(i=0;i<RMS_THREAD_NUM;i++){
+            if(nextRelease[i] == earliest){
+                table[count].Mask |= RMS_READY_BIT(i);
+                nextRelease[i] += rate[i];
+            }
+        }
+        count++;
+        now = earliest;
+    }
+
+    /* Otherwise the slower tick path, same releases: a step per thread at every instant */
+    ReleaseCounts[mode] = ((hyperperiod <= UINT32_MAX) && (now == (uint32_t)hyperperiod)) ? count : 0U;
+    if(mode == RMS_MODE_NORMAL){
+        RMS_ScheduleStart(mode);
+    }
+    return true;
+}
+
+#if RMS_MIXED_CRIT
+/* Hyperperiod boundary of the current table (ReleaseIndex just wrapped to 0): the only
+ * place the mode changes. Both schedules begin with all of their threads released
+ * together, so starting the new table here never shortens a period: a thread kept by
+ * the new mode was due now under the old one as well. The work is one table swap plus
+ * a step per thread that is shed or brought back. Returns this instant's releases. */
+static uint32_t RMS_ModeBoundary(uint32_t released)
+{
+    uint32_t target = ((RequestedMode == RMS_MODE_OVERLOAD) || (ModeHoldPeriods != 0U)) ?
+                      RMS_MODE_OVERLOAD : RMS_MODE_NORMAL;
+    uint32_t oldMask, newMask, changed;
+
+    if(ModeHoldPeriods != 0U){
+        ModeHoldPeriods--;
+    }
+    if(target == ActiveMode){
+        return released;
+    }
+
+    oldMask = released;
+    newMask = ReleaseMasks[target];
+    ActiveMode = (uint8_t)target;
+    RMS_ScheduleStart(target);
+    ModeSwitches++;
+
+    /* Shed threads finish the job in hand, but nothing queued behind it */
+    changed = oldMask & ~newMask;
+    while(changed != 0U){
+        uint32_t index = __CLZ(changed);
+
+        changed &= ~RMS_READY_BIT(index);
+        ThreadTable[index].LateJobs = 0U;
+    }
+    /* Threads brought back are watched from now, not from their last job */
+    changed = newMask & ~oldMask;
+    while(changed != 0U){
+        uint32_t index = __CLZ(changed);
+
+        changed &= ~RMS_READY_BIT(index);
+        RMS_HEALTH_CHECKIN(index);
+    }
+    return newMask;
+}
+
+/* A thread that keeps its rate in overload missed: the set is overloaded */
+static inline void RMS_ModeMiss(uint32_t index)
+{
+    if(ThreadTable[index].OverloadRate == 0U){
+        ModeHoldPeriods = RMS_MODE_HOLD_HYPERPERIODS;
+    }
+}
+
+bool RMS_RequestMode(uint8_t mode)
+{
+    if(mode >= RMS_MODE_COUNT){
+        return false;
+    }
+    RequestedMode = mode;
+    return true;
+}
+
+uint8_t RMS_GetMode(void)
+{
+    return ActiveMode;
+}
+
+uint32_t RMS_GetModeSwitches(void)
+{
+    return ModeSwitches;
+}
+#endif /* RMS_MIXED_CRIT */
+
+/* The instant ReleaseCountdown just reached: its releases, with the countdown
+ * reloaded for the next one. One table lookup, or a step per thread without a table. */
+static inline uint32_t RMS_ScheduleStep(void)
+{
+    uint32_t released;
+    uint8_t i;
+
+    if(ReleaseCount != 0U){
+        released = ReleaseTable[ReleaseIndex].Mask;
+        ReleaseIndex = ((ReleaseIndex + 1U) == ReleaseCount) ? 0U : (ReleaseIndex + 1U);
+        ReleaseCountdown = ReleaseTable[ReleaseIndex].Delay;
+#if RMS_MIXED_CRIT
+        if(ReleaseIndex == 0U){
+            /* End of the hyperperiod: the mode may switch schedules here */
+            released = RMS_ModeBoundary(released);
+        }
+#endif
+        return released;
+    }
+
+    released = 0U;
+    ReleaseCountdown = UINT32_MAX;
+    for(i=0;i<RMS_THREAD_NUM;i++){
+        if((ReleaseMasks[RMS_ACTIVE_MODE] & RMS_READY_BIT(i)) == 0U){
+            continue;
+        }
+        ReleaseLeft[i] -= ReleaseStep;
+        if(ReleaseLeft[i] == 0U){
+            released |= RMS_READY_BIT(i);
+            ReleaseLeft[i] = RMS_ModeRate(i, RMS_ACTIVE_MODE);
+        }
+        if(ReleaseLeft[i] < ReleaseCountdown){
+            ReleaseCountdown = ReleaseLeft[i];
+        }
+    }
+    ReleaseStep = ReleaseCountdown;
+#if RMS_MIXED_CRIT
+    if(released == ReleaseMasks[RMS_ACTIVE_MODE]){
+        /* Every thread of the mode at once: a hyperperiod instant */
+        released = RMS_ModeBoundary(released);
+    }
+#endif
+    return released;
+}
+#endif /* !RMS_HW_RATE_GROUPS */
+
+uint32_t RMS_GetSystemTick(void)
+{
+    return SystemTick;
+}
+
+uint8_t RMS_GetThreadCount(void)
+{
+    return (uint8_t)RMS_THREAD_NUM;
+}
+
+uint8_t RMS_GetRunningThread(void)
+{
+    return (uint8_t)RunningThread;
+}
+
+uint32_t RMS_GetDeadlineMisses(uint8_t index)
+{
+    return ThreadTable[index].DeadlineMisses;
+}
+
+uint8_t RMS_GetRateDivider(uint8_t index)
+{
+    return (ThreadTable[index].RateDivider > 1U) ? ThreadTable[index].RateDivider : 1U;
+}
+
+uint32_t RMS_GetThreadPeriod(uint8_t index)
+{
+    return RMS_ModeRate(index, RMS_ACTIVE_MODE) * RMS_GetRateDivider(index);
+}
+
+/* Rate divider gate, called on every hardware release: false = period not released */
+static bool RMS_DividerGate(ThdObj *thread)
+{
+    if(thread->RateDivider > 1U){
+        if(++thread->DividerCount < thread->RateDivider){
+            return false;
+        }
+        thread->DividerCount = 0U;
+    }
+    return true;
+}
+
+/* Release that found the previous job finished: walks a degraded thread back up */
+static void RMS_OnTimeRelease(ThdObj *thread)
+{
+    if((thread->RateDivider > 1U) && (++thread->OnTimeJobs >= RMS_DEGRADE_RECOVER_JOBS)){
+        thread->RateDivider >>= 1;
+        thread->OnTimeJobs   = 0U;
+        thread->DividerCount = 0U;
+    }
+}
+
+/* Count a deadline miss and apply the thread's policy. true = run the release late. */
+static bool RMS_DeadlineMiss(uint32_t index)
+{
+    ThdObj *thread = &ThreadTable[index];
+    bool late = false;
+
+    thread->DeadlineMisses++;
+    RMS_MODE_MISS(index);
+    switch(thread->MissPolicy){
+    case RMS_MISS_LATE:
+        late = true;
+        break;
+    case RMS_MISS_DEGRADE:
+        /* Shed this thread's load so the higher-rate threads keep their deadlines */
+        if(thread->RateDivider < 2U){
+            thread->RateDivider = 2U;
+        }
+        else if(thread->RateDivider < RMS_DEGRADE_MAX_DIVIDER){
+            thread->RateDivider <<= 1;
+        }
+        thread->OnTimeJobs   = 0U;
+        thread->DividerCount = 0U;
+        break;
+    case RMS_MISS_CALLBACK:
+        late = (thread->MissHook != NULL) && thread->MissHook((uint8_t)index);
+        break;
+    case RMS_MISS_SKIP:
+    default:
+        break;
+    }
+    return late;
+}
+
+#if !RMS_HW_RATE_GROUPS
+/* Tick-side release check: true = publish the release, false = gated or missed */
+static bool RMS_AdmitRelease(uint32_t index)
+{
+    ThdObj *thread = &ThreadTable[index];
+
+    if(!RMS_DividerGate(thread)){
+        return false;
+    }
+    if(thread->ThreadState == STANDBY){
+        RMS_OnTimeRelease(thread);
+        return true;
+    }
+
+    /* Previous job still READY or EXECUTE: the thread is already queued, a late
+     * release is only remembered and picked up by RMS_JobDone() */
+    if(RMS_DeadlineMiss(index) && (thread->LateJobs < RMS_MAX_LATE_JOBS)){
+        LateReleaseTick[index][(LateHead[index] + thread->LateJobs) % RMS_MAX_LATE_JOBS] = SystemTick;
+        thread->LateJobs++;
+    }
+    return false;
+}
+
+#if RMS_SPORADIC
+/* Tick at which an activation made now is given back. SystemTick only advances in the
+ * PIT interrupt, so the part of a tick elapsed since then is rounded up: the budget
+ * never returns less than `rate` ticks after it was charged. */
+static inline uint32_t RMS_SporadicReplenishTick(uint32_t rate)
+{
+#if RMS_TICKLESS
+    uint32_t elapsedCounts = DEMO_PIT_BASEADDR->CHANNEL[DEMO_PIT_CHANNEL].LDVAL -
+                             PIT_GetCurrentTimerCount(DEMO_PIT_BASEADDR, DEMO_PIT_CHANNEL);
+
+    return SystemTick + ((elapsedCounts + PitTickCounts - 1U) / PitTickCounts) + rate;
+#else
+    return SystemTick + 1U + rate;
+#endif
+}
+
+/* Release sporadic server `index` for its posted events if the budget covers one more
+ * activation. The activation is charged up front and handed back ThreadRate ticks
+ * after the release (see RMS_SporadicReplenishTick), which keeps the server's demand within ServerBudgetUs over any
+ * window of ThreadRate ticks. Caller holds RMS_CEILING_TICK, the server is not
+ * queued, and publishes the ready bit itself. */
+static bool RMS_SporadicActivate(uint32_t index)
+{
+    ThdObj *thread = &ThreadTable[index];
+    uint32_t tail;
+
+    if((thread->Events == 0U) || (thread->BudgetUs < thread->ThreadWcetUs) ||
+       (ReplenishCount[index] >= RMS_SPORADIC_REPLENISH_MAX)){
+        return false;
+    }
+
+    thread->BudgetUs -= thread->ThreadWcetUs;
+    tail = (ReplenishHead[index] + ReplenishCount[index]) % RMS_SPORADIC_REPLENISH_MAX;
+    ReplenishQueue[index][tail].Tick     = RMS_SporadicReplenishTick(thread->ThreadRate);
+    ReplenishQueue[index][tail].AmountUs = thread->ThreadWcetUs;
+    if((ReplenishMask == 0U) || ((int32_t)(ReplenishQueue[index][tail].Tick - ReplenishNextTick) < 0)){
+        ReplenishNextTick = ReplenishQueue[index][tail].Tick;
+    }
+    ReplenishCount[index]++;
+    ReplenishMask |= RMS_READY_BIT(index);
+
+    thread->ThreadState = READY;
+    thread->SystemTime  = SystemTick;
+    RMS_STATS_RELEASE(index, DWT_GetCycles());
+    return true;
+}
+
+/* Tick side: return every budget that is due and release the servers that were only
+ * waiting for it. Returns the released servers (RMS_READY_BIT layout). */
+static uint32_t RMS_SporadicReplenish(void)
+{
+    uint32_t released = 0U;
+    uint32_t pending;
+
+    if((ReplenishMask == 0U) || ((int32_t)(SystemTick - ReplenishNextTick) < 0)){
+        return 0U;
+    }
+
+    pending = ReplenishMask;
+    ReplenishNextTick = SystemTick + UINT32_MAX / 2U;
+    while(pending != 0U){
+        uint32_t index = __CLZ(pending);
+        ThdObj *thread = &ThreadTable[index];
+
+        pending &= ~RMS_READY_BIT(index);
+        while((ReplenishCount[index] != 0U) &&
+              ((int32_t)(SystemTick - ReplenishQueue[index][ReplenishHead[index]].Tick) >= 0)){
+            thread->BudgetUs += ReplenishQueue[index][ReplenishHead[index]].AmountUs;
+            ReplenishHead[index] = (uint8_t)((ReplenishHead[index] + 1U) % RMS_SPORADIC_REPLENISH_MAX);
+            ReplenishCount[index]--;
+        }
+        if((thread->ThreadState == STANDBY) && RMS_SporadicActivate(index)){
+            released |= RMS_READY_BIT(index);
+        }
+        if(ReplenishCount[index] == 0U){
+            ReplenishMask &= ~RMS_READY_BIT(index);
+        }
+        else if((int32_t)(ReplenishQueue[index][ReplenishHead[index]].Tick - ReplenishNextTick) < 0){
+            ReplenishNextTick = ReplenishQueue[index][ReplenishHead[index]].Tick;
+        }
+    }
+    return released;
+}
+
+#if RMS_TICKLESS
+/* Ticks until the next tick-side event: a table release or a due replenishment */
+static uint32_t RMS_SporadicNextWake(void)
+{
+    uint32_t ticks = ReleaseCountdown;
+
+    if(ReplenishMask != 0U){
+        uint32_t due = ReplenishNextTick - SystemTick;
+
+        if((int32_t)due <= 0){
+            due = 1U;
+        }
+        if(due < ticks){
+            ticks = due;
+        }
+    }
+    return ticks;
+}
+#endif
+
+static void RMS_SporadicInit(void)
+{
+    uint8_t i;
+
+    for(i=0;i<RMS_THREAD_NUM;i++){
+        ThreadTable[i].BudgetUs = ThreadTable[i].ServerBudgetUs;
+    }
+}
+
+void RMS_SporadicPost(uint8_t index, uint32_t events)
+{
+    ThdObj *thread = &ThreadTable[index];
+    nvic_critical_t crit = NVIC_enter_critical(RMS_CEILING_TICK);
+
+    thread->Events |= events;
+    if((thread->ThreadState == STANDBY) && RMS_SporadicActivate(index)){
+        RMS_ReadySet(RMS_READY_BIT(index));
+#if RMS_PREEMPTIVE
+        if(__CLZ(ThreadReadyMask) < RunningThread){
+            SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+        }
+#endif
+    }
+    NVIC_exit_critical(crit);
+}
+
+uint32_t RMS_SporadicTake(uint8_t index)
+{
+    nvic_critical_t crit = NVIC_enter_critical(RMS_CEILING_TICK);
+    uint32_t events = ThreadTable[index].Events;
+
+    ThreadTable[index].Events = 0U;
+    NVIC_exit_critical(crit);
+    return events;
+}
+#endif /* RMS_SPORADIC */
+
+/* Job completion: run a queued late job or, for a sporadic server, the next posted
+ * events; otherwise go back to STANDBY. Done with the tick held off so a release
+ * cannot slip between the state and ready-set updates. */
+static void RMS_JobDone(uint32_t index)
+{
+    ThdObj *thread = &ThreadTable[index];
+    nvic_critical_t crit = NVIC_enter_critical(RMS_CEILING_TICK);
+
+    if(thread->LateJobs != 0U){
+        uint32_t tick = LateReleaseTick[index][LateHead[index]];
+
+        LateHead[index] = (uint8_t)((LateHead[index] + 1U) % RMS_MAX_LATE_JOBS);
+        thread->LateJobs--;
+        /* Stamp the queued release: whole ticks after the job that just finished */
+        RMS_STATS_RELEASE(index, ThreadStats[index].ReleaseCycle + ((tick - thread->SystemTime) * TickCycles));
+        thread->SystemTime  = tick;
+        thread->ThreadState = READY;
+#if !RMS_PREEMPTIVE
+        RMS_ReadySet(RMS_READY_BIT(index));
+#endif
+    }
+    else if(RMS_SPORADIC_ACTIVATE(index)){
+        /* Events arrived while the job ran and the budget covers them */
+#if !RMS_PREEMPTIVE
+        RMS_ReadySet(RMS_READY_BIT(index));
+#endif
+    }
+    else{
+        thread->ThreadState = STANDBY;
+#if RMS_PREEMPTIVE
+        RMS_ReadyClear(RMS_READY_BIT(index));
+#endif
+    }
+    NVIC_exit_critical(crit);
+}
+#endif /* !RMS_HW_RATE_GROUPS */
+
+#if NVIC_PROFILE
+/* Core cycles per PIT count, set before the tick starts */
+static uint32_t PitCycleRatio;
+
+/* PIT0 entry latency: the counter reloaded at expiry and has counted down since */
+static uint32_t RMS_PitLatencyProbe(void)
+{
+    uint32_t counts = DEMO_PIT_BASEADDR->CHANNEL[DEMO_PIT_CHANNEL].LDVAL -
+                      DEMO_PIT_BASEADDR->CHANNEL[DEMO_PIT_CHANNEL].CVAL;
+    return counts * PitCycleRatio;
+}
+#endif
+
+#if RMS_TELEMETRY
+/* Snapshot temperature and thread timing straight into the telemetry back buffer */
+static void RMS_SendTelemetry(void)
+{
+    telemetry_frame_t *frame = TELEMETRY_Acquire();
+    uint8_t count = (RMS_THREAD_NUM < TELEMETRY_MAX_THREADS) ? RMS_THREAD_NUM : TELEMETRY_MAX_THREADS;
+    uint8_t index;
+    nvic_critical_t crit;
+
+    frame->tick             = SystemTick;
+    frame->tempDeci         = ADC_GetLastTempDeciC();
+    frame->avgTempDeci      = ADC_GetAvgTempDeciC();
+    frame->filteredTempDeci = ADC_GetFilteredTempDeciC();
+    frame->threadCount      = count;
+    frame->reserved         = 0U;
+
+    /* One consistent snapshot of all threads; ISRs are not held off */
+    crit = NVIC_enter_critical(RMS_CEILING_SCHED);
+    for(index = 0U; index < count; index++){
+#if RMS_STATS
+        frame->thread[index].execAvgCycles    = RMS_GetAvgExecCycles(index);
+        frame->thread[index].execMaxCycles    = ThreadStats[index].ExecMax;
+        frame->thread[index].latencyMaxCycles = ThreadStats[index].LatencyMax;
+        frame->thread[index].jobs             = ThreadStats[index].Jobs;
+        frame->thread[index].overruns         = ThreadStats[index].Overruns;
+#else
+        memset(&frame->thread[index], 0, sizeof(frame->thread[index]));
+#endif
+    }
+    NVIC_exit_critical(crit);
+
+    /* Link still busy with the previous frame: this one is dropped, never waited on */
+    (void)TELEMETRY_Submit(frame);
+}
+#endif
+
+#if RMS_TICKLESS
+/* Make the running PIT period expire `ticks` ticks after the expiry being serviced.
+ * The counts already elapsed since that expiry are deducted from the first period so
+ * releases do not drift, then LDVAL is set to the full period for later reloads. */
+static void RMS_TicklessProgram(uint32_t ticks)
+{
+    uint32_t elapsedCounts;
+
+    if(ticks == ProgrammedTicks){
+        return; /* The PIT already reloaded with this period */
+    }
+
+    elapsedCounts = DEMO_PIT_BASEADDR->CHANNEL[DEMO_PIT_CHANNEL].LDVAL -
+                    PIT_GetCurrentTimerCount(DEMO_PIT_BASEADDR, DEMO_PIT_CHANNEL);
+
+    PIT_StopTimer(DEMO_PIT_BASEADDR, DEMO_PIT_CHANNEL);
+    PIT_SetTimerPeriod(DEMO_PIT_BASEADDR, DEMO_PIT_CHANNEL, (ticks * PitTickCounts) - elapsedCounts);
+    PIT_StartTimer(DEMO_PIT_BASEADDR, DEMO_PIT_CHANNEL);
+    /* Takes effect at the next reload */
+    PIT_SetTimerPeriod(DEMO_PIT_BASEADDR, DEMO_PIT_CHANNEL, ticks * PitTickCounts);
+
+    ProgrammedTicks = ticks;
+}
+#endif /* RMS_TICKLESS */
+
+#if RMS_HW_RATE_GROUPS
+/* One job of rate group `index`, run to completion in its own PIT channel interrupt.
+ * The hardware reload is the release; a higher group's channel preempts through the
+ * NVIC, so nothing is queued or dispatched in software. */
+static inline void RMS_RateGroupRun(uint32_t index)
+{
+#if RMS_STATS
+    uint32_t now = DWT_GetCycles();
+#endif
+
+    ThdObj *thread = &ThreadTable[index];
+
+    PIT_ClearStatusFlags(DEMO_PIT_BASEADDR, (pit_chnl_t)index, kPIT_TimerFlag);
+    if(index == 0U){
+        /* Channel 0 keeps system time, in steps of its own period */
+        SystemTick += thread->ThreadRate;
+        RMS_HEALTH_SUPERVISE();
+    }
+
+    if(RMS_DividerGate(thread)){
+        /* Groups nest by priority: the preempted group owns the CPU again on return */
+        uint32_t preempted = RunningThread;
+
+        thread->SystemTime = SystemTick;
+        thread->ThreadState = EXECUTE;
+        RunningThread = index;
+        RMS_STATS_RELEASE(index, now);
+        RMS_STATS_JOB_START(index);
+        thread->ThreadHandler();
+        RMS_STATS_JOB_END(index);
+        RMS_HEALTH_CHECKIN(index);
+        thread->ThreadState = STANDBY;
+        RunningThread = preempted;
+
+        /* The channel expired again while the job ran: deadline missed. A late job
+         * leaves the flag set so the interrupt re-enters as soon as this one returns. */
+        if(PIT_GetStatusFlags(DEMO_PIT_BASEADDR, (pit_chnl_t)index) & kPIT_TimerFlag){
+            if(!RMS_DeadlineMiss(index)){
+                PIT_ClearStatusFlags(DEMO_PIT_BASEADDR, (pit_chnl_t)index, kPIT_TimerFlag);
+                if(index == 0U){
+                    SystemTick += thread->ThreadRate;
+                }
+            }
+        }
+        else{
+            RMS_OnTimeRelease(thread);
+        }
+    }
+
+    __DSB();
+}
+
+void PIT0_IRQHandler(void)
+{
+    RMS_RateGroupRun(0U);
+}
+
+#if RMS_HW_RATE_GROUPS >= 2
+void PIT1_IRQHandler(void)
+{
+    RMS_RateGroupRun(1U);
+}
+#endif
+
+#if RMS_HW_RATE_GROUPS >= 3
+void PIT2_IRQHandler(void)
+{
+    RMS_RateGroupRun(2U);
+}
+#endif
+
+#if RMS_HW_RATE_GROUPS >= 4
+void PIT3_IRQHandler(void)
+{
+    RMS_RateGroupRun(3U);
+}
+#endif
+#else
+void PIT_LED_HANDLER(void)
+{
+    uint32_t released = 0U;
+    uint32_t pending;
+#if RMS_SPORADIC
+    uint32_t sporadic;
+#endif
+#if RMS_STATS
+    uint32_t now = DWT_GetCycles();
+#endif
+#if RMS_TICKLESS
+    /* One interrupt covers all ticks since the previous one */
+    uint32_t elapsed = ProgrammedTicks;
+#else
+    const uint32_t elapsed = 1U;
+#endif
+
+    RMS_BENCH_STAMP(BENCH_STAMP_ISR_ENTRY);
+
+	/* Clear interrupt flag.*/
+    PIT_ClearStatusFlags(DEMO_PIT_BASEADDR, DEMO_PIT_CHANNEL, kPIT_TimerFlag);
+    pitIsrFlag = true;
+    /* Added for, and affects, all PIT handlers. For CPU clock which is much larger than the IP bus clock,
+     * CPU can run out of the interrupt handler before the interrupt flag being cleared, resulting in the
+     * CPU's entering the handler again and again. Adding DSB can prevent the issue from happening.
+     */
+
+    SystemTick += elapsed;
+    RMS_HEALTH_SUPERVISE();
+
+    /* One step of the cyclic schedule per release instant */
+    ReleaseCountdown -= elapsed;
+    if(ReleaseCountdown == 0U){
+    	released = RMS_ScheduleStep();
+    }
+
+#if RMS_SPORADIC
+    /* Servers released by a returned budget are already READY */
+    sporadic = RMS_SporadicReplenish();
+#endif
+
+    /* Only the released threads are touched */
+    pending = released;
+    while(pending != 0U){
+    	uint32_t index = __CLZ(pending);
+
+    	pending &= ~RMS_READY_BIT(index);
+    	if(!RMS_AdmitRelease(index)){
+    		released &= ~RMS_READY_BIT(index);
+    		continue;
+    	}
+    	ThreadTable[index].ThreadState = READY;
+    	ThreadTable[index].SystemTime = SystemTick;
+    	RMS_STATS_RELEASE(index, now);
+    }
+
+#if RMS_SPORADIC
+    released |= sporadic;
+#endif
+
+#if RMS_TICKLESS
+    /* Sleep straight through to the next release instant */
+#if RMS_SPORADIC
+    RMS_TicklessProgram(RMS_SporadicNextWake());
+#else
+    RMS_TicklessProgram(ReleaseCountdown);
+#endif
+#endif
+
+    /* Publish all releases of this tick with a single ready-set update */
+    if(released != 0U){
+    	RMS_ReadySet(released);
+#if RMS_PREEMPTIVE
+    	/* A release that outranks the running thread preempts it right away */
+    	if(__CLZ(ThreadReadyMask) < RunningThread){
+    		SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+    	}
+#endif
+    }
+
+    RMS_BENCH_STAMP(BENCH_STAMP_ISR_EXIT);
+    __DSB();
+}
+#endif /* RMS_HW_RATE_GROUPS */
+
+#if RMS_PREEMPTIVE
+/* Body of every preemptive thread: run one job per release, then give the CPU
+ * back. The thread is only resumed by PendSV once it is READY again. */
+static void RMS_ThreadEntry(ThdObj *thread)
+{
+    uint32_t index = (uint32_t)(thread - ThreadTable);
+
+    while (true)
+    {
+        RMS_STATS_JOB_START(index);
+        thread->ThreadHandler();
+        RMS_STATS_JOB_END(index);
+        RMS_HEALTH_CHECKIN(index);
+
+        /* Keeps the ready bit when a late job is queued, so the loop runs it next */
+        RMS_JobDone(index);
+
+        SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+        __DSB();
+        __ISB();
+    }
+}
+
+/* Build the initial frame so the first PendSV into a thread "returns" to RMS_ThreadEntry. */
+static void RMS_ThreadStackInit(uint8_t index)
+{
+    uint32_t *sp = &ThreadStack[index][RMS_THREAD_STACK_WORDS - RMS_SW_FRAME_WORDS - RMS_HW_FRAME_WORDS];
+    uint32_t *frame = &sp[RMS_SW_FRAME_WORDS];
+
+#if STACK_MONITOR
+    /* Painted (and guarded) before the initial frame goes in */
+    (void)STACK_Register("thread", ThreadStack[index], RMS_THREAD_STACK_WORDS);
+#endif
+    memset(sp, 0, (RMS_SW_FRAME_WORDS + RMS_HW_FRAME_WORDS) * sizeof(uint32_t));
+    sp[RMS_SW_FRAME_WORDS - 1U]  = RMS_EXC_RETURN_PSP;
+    frame[RMS_HW_FRAME_R0]       = (uint32_t)&ThreadTable[index];
+    frame[RMS_HW_FRAME_LR]       = 0xFFFFFFFFUL;  /* RMS_ThreadEntry never returns */
+    frame[RMS_HW_FRAME_PC]       = (uint32_t)RMS_ThreadEntry & ~1UL;
+    frame[RMS_HW_FRAME_XPSR]     = RMS_INITIAL_XPSR;
+
+    ThreadTable[index].StackPointer = (uint32_t)sp;
+}
+
+/* Called from PendSV with the saved stack pointer of the outgoing context; returns the
+ * stack pointer of the highest-priority ready thread, or of idle when none is ready. */
+__attribute__((used)) uint32_t RMS_SwitchContext(uint32_t sp)
+{
+    uint32_t next = __CLZ(ThreadReadyMask);
+
+    if(RunningThread == RMS_IDLE_INDEX){
+        IdleStackPointer = sp;
+    }
+    else{
+        ThreadTable[RunningThread].StackPointer = sp;
+    }
+
+    RunningThread = next;
+    if(next == RMS_IDLE_INDEX){
+        return IdleStackPointer;
+    }
+
+    ThreadTable[next].ThreadState = EXECUTE;
+    return ThreadTable[next].StackPointer;
+}
+
+/* Lowest-priority context switch. Threads run on PSP; the idle context (main) runs on
+ * MSP, so its registers are pushed on MSP itself and MSP is only restored when idle
+ * resumes. R3 is saved as padding to keep the stack 8-byte aligned. */
+__attribute__((naked)) void PendSV_Handler(void)
+{
+    __asm volatile(
+        ".syntax unified                 \n"
+        "TST     LR, #4                  \n"
+        "BNE     1f                      \n"
+        RMS_FPU_PUSH
+        "PUSH    {R3-R11, LR}            \n"
+        "MOV     R0, SP                  \n"
+        "B       2f                      \n"
+        "1:                              \n"
+        "MRS     R0, PSP                 \n"
+        RMS_FPU_SAVE
+        "STMDB   R0!, {R3-R11, LR}       \n"
+        "2:                              \n"
+        "BL      RMS_SwitchContext       \n"
+        "LDMIA   R0!, {R3-R11, LR}       \n"
+        RMS_FPU_RESTORE
+        "TST     LR, #4                  \n"
+        "ITE     EQ                      \n"
+        "MSREQ   MSP, R0                 \n"
+        "MSRNE   PSP, R0                 \n"
+        "BX      LR                      \n"
+        ".syntax divided                 \n");
+}
+#endif /* RMS_PREEMPTIVE */
+
+/*!
+ * @brief Main function
+ */
+int main(void)
+{
+    uint8_t tableCounter;
+
+	/* Structure of initialize PIT */
+    pit_config_t pitConfig;
+
+#if STACK_MONITOR
+    /* Paint the MSP stack before anything deeper than main has run */
+    STACK_Init();
+#endif
+
+#if RTT_LOG
+    /* Log ring first, so the probe can attach before anything is printed */
+    RTT_Init();
+#endif
+
+    /* Board pin, clock, debug console init */
+    BOARD_InitBootPins();
+    BOARD_InitBootClocks();
+    BOARD_InitDebugConsole();
+
+#if CRASH_CAPTURE
+    /* Cause of the previous reset, if it was a captured fault */
+    CRASH_ReportPrevious();
+#endif
+#if HEALTH_MONITOR
+    /* State snapshot taken before a watchdog reset, if that is how we got here */
+    HEALTH_ReportPrevious();
+    (void)HEALTH_CheckTiming();
+#endif
+
+    /* Initialize and enable LED */
+    LED_INIT();
+
+    /* Temperature input sampled from Thd_10ms */
+    ADC_InitModule();
+#if RMS_ADC_ADAPTIVE
+    ADC_SetAdaptive(true);
+#endif
+
+#if !RMS_HW_RATE_GROUPS
+    /* Precompute the release schedule of one hyperperiod, for every mode */
+    for(tableCounter=0;tableCounter<RMS_TABLE_MODES;tableCounter++){
+        if(!RMS_BuildReleaseTable(tableCounter)){
+            PRINTF("\r\nRMS: a thread has no rate, or none is periodic: scheduler not started");
+            while (true)
+            {
+            }
+        }
+    }
+#endif
+
+    /* Verify the task set before releasing any thread */
+    if(RMS_CheckSchedulability() != RMS_SCHEDULABLE){
+#if RMS_SCHED_ENFORCE
+        PRINTF("\r\nRMS: task set not schedulable, scheduler not started");
+        while (true)
+        {
+        }
+#else
+        PRINTF("\r\nRMS: task set not schedulable, starting anyway");
+#endif
+    }
+
+#if RMS_STATS
+    RMS_StatsInit();
+#endif
+#if RMS_SPORADIC
+    /* Full budgets, then the button interrupts that post to Thd_events */
+    RMS_SporadicInit();
+    EVENT_Init(RMS_EVENT_THREAD);
+#endif
+
+#if RMS_PREEMPTIVE
+    /* Give every thread its own stack and make PendSV the lowest-priority exception */
+    for(tableCounter=0;tableCounter<RMS_THREAD_NUM;tableCounter++){
+        RMS_ThreadStackInit(tableCounter);
+    }
+    NVIC_SetPriority(PendSV_IRQn, RMS_PENDSV_PRIORITY);
+#endif
+
+#if STACK_GUARD
+    /* Every stack is registered by now: arm the SYSMPU guards under them */
+    if(!STACK_EnableGuards()){
+        PRINTF("\r\nSTACK: SYSMPU region 0 still open to the core, guards inactive");
+    }
+#endif
+
+    /*
+     * pitConfig.enableRunInDebug = false;
+     */
+    PIT_GetDefaultConfig(&pitConfig);
+
+    /* Init pit module */
+    PIT_Init(DEMO_PIT_BASEADDR, &pitConfig);
+
+#if RMS_HW_RATE_GROUPS
+    /* Every rate group gets its own channel, period = ThreadRate ticks */
+    for(tableCounter=0;tableCounter<RMS_THREAD_NUM;tableCounter++){
+        PIT_SetTimerPeriod(DEMO_PIT_BASEADDR, (pit_chnl_t)tableCounter,
+                           ThreadTable[tableCounter].ThreadRate * USEC_TO_COUNT(RMS_TICK_US, PIT_SOURCE_CLOCK));
+        PIT_EnableInterrupts(DEMO_PIT_BASEADDR, (pit_chnl_t)tableCounter, kPIT_TimerInterruptEnable);
+    }
+#elif RMS_TICKLESS
+    /* First expiry lands directly on the first release instant */
+    PitTickCounts   = (uint32_t)USEC_TO_COUNT(RMS_TICK_US, PIT_SOURCE_CLOCK);
+    ProgrammedTicks = ReleaseCountdown;
+    PIT_SetTimerPeriod(DEMO_PIT_BASEADDR, DEMO_PIT_CHANNEL, ProgrammedTicks * PitTickCounts);
+#else
+    /* Set timer period for channel 0 */
+    PIT_SetTimerPeriod(DEMO_PIT_BASEADDR, DEMO_PIT_CHANNEL, USEC_TO_COUNT(RMS_TICK_US, PIT_SOURCE_CLOCK));
+#endif
+
+#if !RMS_HW_RATE_GROUPS
+    /* Enable timer interrupts for channel 0 */
+    PIT_EnableInterrupts(DEMO_PIT_BASEADDR, DEMO_PIT_CHANNEL, kPIT_TimerInterruptEnable);
+#endif
+
+    /* Priorities and enables of every used IRQ, PIT0 included, from NVIC_config.h */
+    NVIC_init();
+#if NVIC_PROFILE
+    PitCycleRatio = SystemCoreClock / PIT_SOURCE_CLOCK;
+    (void)NVIC_profile_set_latency_probe(PIT_CH0_IRQ, RMS_PitLatencyProbe);
+#endif
+
+    /* Start channel 0 */
+    PRINTF("\r\nStarting channel No.0 ...");
+#if RMS_TELEMETRY
+    /* From here on UART0 carries binary frames only */
+    TELEMETRY_Init();
+#endif
+#if HEALTH_MONITOR
+    /* Watchdogs start with the tick: the first service is due one window in */
+    HEALTH_Init();
+#endif
+#if RMS_HW_RATE_GROUPS
+    /* Back-to-back starts keep the channels in phase (all release at t = 0) */
+    for(tableCounter=0;tableCounter<RMS_THREAD_NUM;tableCounter++){
+        PIT_StartTimer(DEMO_PIT_BASEADDR, (pit_chnl_t)tableCounter);
+    }
+#else
+    PIT_StartTimer(DEMO_PIT_BASEADDR, DEMO_PIT_CHANNEL);
+#endif
+
+#if RMS_PREEMPTIVE || RMS_HW_RATE_GROUPS
+    /* main becomes the idle context; threads run from PendSV or the PIT interrupts */
+    while (true)
+    {
+        Thd_idle();
+    }
+#else
+#if RMS_BENCH
+    BENCH_Run();
+#endif
+    while (true)
+    {
+        if(!RMS_DispatchNext()){
+            Thd_idle();
+        }
+    }
+#endif
+}
+
+#if !RMS_PREEMPTIVE && !RMS_HW_RATE_GROUPS
+bool RMS_DispatchNext(void)
+{
+    uint32_t ready = ThreadReadyMask;
+    uint8_t index;
+
+    if(ready == 0U){
+        return false;
+    }
+
+    /* Highest-priority ready thread is the leading set bit: O(1) dispatch */
+    index = (uint8_t)__CLZ(ready);
+    RMS_ReadyClear(RMS_READY_BIT(index));
+
+    ThreadTable[index].ThreadState = EXECUTE;
+    RunningThread = index;
+    RMS_STATS_JOB_START(index);
+    ThreadTable[index].ThreadHandler();
+    RMS_STATS_JOB_END(index);
+    RMS_HEALTH_CHECKIN(index);
+    RunningThread = RMS_IDLE_INDEX;
+    RMS_JobDone(index);
+    return true;
+}
+#endif
+
+void Thd_2ms(void){
+	static volatile uint8_t counter = 0;
+	counter++;
+}
+
+void Thd_5ms(void){
+	static volatile uint8_t counter = 0;
+	counter++;
+}
+
+void Thd_10ms(void){
+	static volatile uint8_t counter = 0;
+	counter++;
+
+	ADC_Service(RMS_TICKS_TO_MS(RMS_GetSystemTick()));
+#if RMS_TELEMETRY
+	RMS_SendTelemetry();
+#endif
+#if RMS_MIXED_CRIT
+	/* Sensor alarm: the overload mode sheds the low-criticality threads while it lasts */
+	if(ADC_GetAvgTempDeciC() >= RMS_TEMP_ALARM_DECI){
+		(void)RMS_RequestMode(RMS_MODE_OVERLOAD);
+	}
+	else if(ADC_GetAvgTempDeciC() < (RMS_TEMP_ALARM_DECI - RMS_TEMP_ALARM_HYST_DECI)){
+		(void)RMS_RequestMode(RMS_MODE_NORMAL);
+	}
+#endif
+#if RMS_ADC_ADAPTIVE
+	/* Last thing in the job: averaging follows the budget left over */
+	ADC_AdaptiveUpdate(RMS_GetJobSlackUs(RMS_ADC_THREAD));
+#endif
+}
+
+#if RMS_SPORADIC
+/* Sporadic server: one activation handles every event posted so far */
+void Thd_events(void){
+	static adc_filter_t filter = ADC_FILTER_MEAN;
+	uint32_t events = RMS_SporadicTake(RMS_EVENT_THREAD);
+
+	if(events & EVENT_SW2){
+		/* Cycle mean -> EMA -> median */
+		filter = (filter == ADC_FILTER_MEDIAN) ? ADC_FILTER_MEAN : (adc_filter_t)(filter + 1);
+		ADC_SetFilter(filter);
+	}
+	if(events & EVENT_SW3){
+		LED_TOGGLE();
+	}
+}
+#endif
+
+#if !RMS_TICKLESS && !RMS_HW_RATE_GROUPS
+__attribute__((weak)) void RMS_IdleHook(void){
+}
+#endif
+
+void Thd_idle(void){
+	/* High-water marks are measured here, where nothing else wants the CPU */
+	RMS_STACK_SCAN();
+
+#if RMS_TICKLESS || RMS_HW_RATE_GROUPS
+	/* Wait mode until the next PIT release. PIT stops in the deeper STOP modes, so
+	 * SLEEPDEEP stays clear. With PRIMASK set, a release landing between the ready
+	 * check and WFI still wakes the core, and its ISR runs once PRIMASK is cleared. */
+	__disable_irq();
+	if(ThreadReadyMask == 0U){
+		__WFI();
+	}
+	__enable_irq();
+#else
+	RMS_IdleHook();
+#endif
+}
@@ -1,24 +1,322 @@
-/*
- * RMS.h
- *
- *  Created on: 5 sep. 2025
- *      Author: mauri
- */
-
-#ifndef RMS_H_
-#define RMS_H_
-
-typedef enum{
-	STANDBY = 0,
-	READY,
-	EXECUTE
-}ThdState;
-
-typedef struct{
-	void(*ThreadHandler)(void);
-	uint8_t ThreadState;
-	uint8_t ThreadRate;
-	uint8_t SystemTime;
-}ThdObj;
-
-#endif /* RMS_H_ */
+/*
+ * RMS.h
+ *
+ *  Created on: 5 sep. 2025
+ *      Author: mauri
+ */
+
+#ifndef RMS_H_
+#define RMS_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* The ready set is a 32-bit bitmap, one bit per ThreadTable entry. */
+#define RMS_MAX_THREADS     32U
+
+/* ThreadTable index 0 (highest rate, highest priority) maps to the MSB so that
+ * __CLZ() of the ready set yields the index of the highest-priority ready thread. */
+#define RMS_READY_BIT(idx)  (0x80000000UL >> (idx))
+
+/* Running thread index of the idle context (main). Equals __CLZ(0), so an empty
+ * ready set selects idle without a branch. */
+#define RMS_IDLE_INDEX      RMS_MAX_THREADS
+
+/* Scheduler tick period (microseconds); ThreadRate is expressed in ticks */
+#ifndef RMS_TICK_US
+#define RMS_TICK_US             1000U
+#endif
+
+/* Tick count to milliseconds (rounded down), without the multiply for whole-ms ticks */
+#define RMS_TICKS_TO_MS(t)      (((RMS_TICK_US % 1000U) == 0U) ? ((t) * (RMS_TICK_US / 1000U)) : \
+                                                                 (((t) * RMS_TICK_US) / 1000U))
+
+/* Capacity of the hyperperiod release table, one entry per distinct release
+ * instant within the hyperperiod (LCM of all ThreadRate values). A thread set that
+ * needs more runs on per-thread countdowns: a step per thread at each instant. */
+#ifndef RMS_RELEASE_TABLE_SIZE
+#define RMS_RELEASE_TABLE_SIZE  64U
+#endif
+
+/* Build option: 1 = tickless. The PIT is reprogrammed in each interrupt to expire
+ * exactly at the next release in ThreadTable, and idle sleeps in WFI in between.
+ * 0 = fixed RMS_TICK_US interrupt. */
+#ifndef RMS_TICKLESS
+#define RMS_TICKLESS            0
+#endif
+
+/* Build option: 1 = refuse to start when the startup analysis finds a deadline
+ * miss, 0 = only report the offending threads and start anyway. */
+#ifndef RMS_SCHED_ENFORCE
+#define RMS_SCHED_ENFORCE       1
+#endif
+
+/* RMS_CheckSchedulability() result when every thread meets its deadline */
+#define RMS_SCHEDULABLE         0xFFU
+
+/* Build option: 1 = preemptive dispatch, each thread runs on its own stack and a
+ * higher-rate release preempts the running thread through PendSV.
+ * 0 = cooperative run-to-completion dispatch from the main loop. */
+#ifndef RMS_PREEMPTIVE
+#define RMS_PREEMPTIVE          0
+#endif
+
+/* Build option: N = 1..4 hardware rate groups. ThreadTable[i] is driven by PIT channel i
+ * with period ThreadRate and runs to completion inside PITi_IRQHandler; the channel
+ * priorities (channel 0 highest) give the rate-monotonic preemption, so there is no
+ * tick, release table or ready set. N must equal the number of ThreadTable entries.
+ * 0 = all threads released from the PIT0 tick. */
+#ifndef RMS_HW_RATE_GROUPS
+#define RMS_HW_RATE_GROUPS      0
+#endif
+#if RMS_HW_RATE_GROUPS && (RMS_PREEMPTIVE || RMS_TICKLESS)
+#error "RMS_HW_RATE_GROUPS replaces the tick and the dispatcher: disable RMS_PREEMPTIVE and RMS_TICKLESS"
+#endif
+#if RMS_HW_RATE_GROUPS > 4
+#error "RMS_HW_RATE_GROUPS: the PIT has four channels"
+#endif
+
+/* Private stack size of each thread in preemptive mode (32-bit words), STACK_GUARD
+ * guard included */
+#ifndef RMS_THREAD_STACK_WORDS
+#define RMS_THREAD_STACK_WORDS  256U
+#endif
+
+/* PIT0 tick priority and the BASEPRI ceilings of the scheduler's shared state
+ * (see NVIC_enter_critical). RMS_CEILING_TICK holds off the tick, for data written by
+ * PIT_LED_HANDLER. RMS_CEILING_SCHED only holds off PendSV (lowest priority), i.e.
+ * thread preemption, for data shared between threads; every ISR keeps running. */
+#define RMS_TICK_PRIORITY       PRIORITY_1
+#define RMS_CEILING_TICK        RMS_TICK_PRIORITY
+#if RMS_HW_RATE_GROUPS
+/* Rate group n runs at PIT channel n's priority; threads are ISRs, so the ceiling of
+ * data shared between them is the highest group */
+#define RMS_RATE_GROUP_PRIORITY(n)  (RMS_TICK_PRIORITY + (n))
+#define RMS_CEILING_SCHED       RMS_TICK_PRIORITY
+#else
+#define RMS_CEILING_SCHED       PRIORITY_15
+#endif
+
+/* Build option: 1 = record per-thread execution time, release-to-start latency and
+ * overruns with the DWT cycle counter. 0 = instrumentation compiled out entirely. */
+#ifndef RMS_STATS
+#define RMS_STATS               0
+#endif
+
+/* Build option: 1 = Thd_10ms streams a binary telemetry frame (temperature and, with
+ * RMS_STATS, per-thread timing) over UART0 by eDMA. The debug console shares UART0,
+ * so PRINTF is only used before the scheduler starts. */
+#ifndef RMS_TELEMETRY
+#define RMS_TELEMETRY           0
+#endif
+
+/* Build option: 1 = benchmark image. Once the tick is running, main() hands over to
+ * BENCH_Run() (BENCH.h), which times the tick ISR, the dispatcher and the ADC paths
+ * and reports over semihosting; the scheduler then continues as usual. */
+#ifndef RMS_BENCH
+#define RMS_BENCH               0
+#endif
+#if RMS_BENCH && (RMS_PREEMPTIVE || RMS_HW_RATE_GROUPS)
+#error "RMS_BENCH times the cooperative dispatcher: disable RMS_PREEMPTIVE and RMS_HW_RATE_GROUPS"
+#endif
+
+/* Build option: 1 = ThreadTable includes a sporadic server, Thd_events, activated by
+ * GPIO edge events (EVENT.h: SW2/SW3) instead of the release table. See ServerBudgetUs. */
+#ifndef RMS_SPORADIC
+#define RMS_SPORADIC            0
+#endif
+#if RMS_SPORADIC && RMS_HW_RATE_GROUPS
+#error "RMS_SPORADIC: hardware rate groups only run periodic threads"
+#endif
+/* Build option: 1 = Thd_10ms runs the ADC with adaptive hardware averaging, fed with
+ * the budget each job leaves unused (ADC_AdaptiveUpdate). Needs RMS_STATS. */
+#ifndef RMS_ADC_ADAPTIVE
+#define RMS_ADC_ADAPTIVE        0
+#endif
+#if RMS_ADC_ADAPTIVE && !RMS_STATS
+#error "RMS_ADC_ADAPTIVE: the job slack is measured by RMS_STATS"
+#endif
+
+/* Build option: 1 = mixed-criticality modes. RMS_MODE_OVERLOAD runs each thread at its
+ * OverloadRate (slowed or shed) and keeps the others at ThreadRate. It is entered on
+ * request (RMS_RequestMode) or when a thread that keeps its rate misses a deadline,
+ * and only ever at a hyperperiod boundary. */
+#ifndef RMS_MIXED_CRIT
+#define RMS_MIXED_CRIT          0
+#endif
+#if RMS_MIXED_CRIT && RMS_HW_RATE_GROUPS
+#error "RMS_MIXED_CRIT: the mode tables are release tables, hardware rate groups have none"
+#endif
+
+/* RMS_MIXED_CRIT: hyperperiods spent in RMS_MODE_OVERLOAD after a miss triggered it */
+#ifndef RMS_MODE_HOLD_HYPERPERIODS
+#define RMS_MODE_HOLD_HYPERPERIODS  8U
+#endif
+
+/* Pending replenishments per sporadic server; bounds ServerBudgetUs / ThreadWcetUs */
+#ifndef RMS_SPORADIC_REPLENISH_MAX
+#define RMS_SPORADIC_REPLENISH_MAX  4U
+#endif
+
+/* Scheduler modes; each has its own release table */
+typedef enum{
+	RMS_MODE_NORMAL = 0,	/* Every thread at ThreadRate */
+	RMS_MODE_OVERLOAD,		/* Every thread at its OverloadRate */
+	RMS_MODE_COUNT
+}RmsMode;
+
+/* OverloadRate of a thread that is not released at all in RMS_MODE_OVERLOAD */
+#define RMS_RATE_SHED       UINT32_MAX
+
+typedef enum{
+	STANDBY = 0,
+	READY,
+	EXECUTE
+}ThdState;
+
+/* What a release does when it finds the previous job of the thread unfinished
+ * (still READY or EXECUTE). The miss is counted in DeadlineMisses in every case. */
+typedef enum{
+	RMS_MISS_SKIP = 0,	/* Drop the new release; the outstanding job is the only one */
+	RMS_MISS_LATE,		/* Queue the release and run it right after the late job */
+	RMS_MISS_DEGRADE,	/* Skip, and halve the thread's rate until it keeps up again */
+	RMS_MISS_CALLBACK	/* Ask MissHook (ISR context): true = run late, false = skip */
+}RmsMissPolicy;
+
+/* Backlog of released-but-not-run jobs kept by RMS_MISS_LATE; later ones are skipped */
+#ifndef RMS_MAX_LATE_JOBS
+#define RMS_MAX_LATE_JOBS           2U
+#endif
+/* RMS_MISS_DEGRADE: slowest rate is ThreadRate * RMS_DEGRADE_MAX_DIVIDER (power of two) */
+#ifndef RMS_DEGRADE_MAX_DIVIDER
+#define RMS_DEGRADE_MAX_DIVIDER     8U
+#endif
+/* RMS_MISS_DEGRADE: on-time jobs in a row before the rate is doubled back */
+#ifndef RMS_DEGRADE_RECOVER_JOBS
+#define RMS_DEGRADE_RECOVER_JOBS    16U
+#endif
+
+typedef struct{
+	void(*ThreadHandler)(void);
+	uint8_t ThreadState;
+	uint32_t ThreadRate;	/* Period (ticks) */
+	uint32_t OverloadRate;	/* Period in RMS_MODE_OVERLOAD: 0 = ThreadRate, RMS_RATE_SHED = none */
+	uint32_t SystemTime;	/* Tick of the latest release */
+	uint32_t ThreadWcetUs;	/* Worst-case execution budget per job (microseconds) */
+	uint8_t MissPolicy;		/* RmsMissPolicy */
+	bool (*MissHook)(uint8_t index);	/* RMS_MISS_CALLBACK decision */
+	uint32_t DeadlineMisses;	/* Releases that found the previous job unfinished */
+	uint8_t LateJobs;		/* Queued late jobs (RMS_MISS_LATE / RMS_MISS_CALLBACK) */
+	uint8_t RateDivider;	/* Released every RateDivider-th period (0 or 1 = every period) */
+	uint8_t DividerCount;
+	uint8_t OnTimeJobs;		/* On-time releases since the last degrade step */
+	/* Sporadic server (ServerBudgetUs != 0): released by RMS_SporadicPost(), not by the
+	 * release table. Each activation is charged ThreadWcetUs from BudgetUs and given back
+	 * ThreadRate ticks later, so the analysis treats it as a periodic task with period
+	 * ThreadRate and cost ServerBudgetUs. */
+	uint32_t ServerBudgetUs;	/* Capacity per replenishment period (0 = periodic thread) */
+	uint32_t BudgetUs;		/* Capacity left for new activations */
+	volatile uint32_t Events;	/* Posted event bits not yet taken by the handler */
+#if RMS_PREEMPTIVE
+	uint32_t StackPointer;	/* Saved PSP while the thread is switched out */
+#endif
+}ThdObj;
+
+/* Thread set, highest rate first, and its number of entries. */
+extern ThdObj ThreadTable[];
+uint8_t RMS_GetThreadCount(void);
+
+/* ThreadTable index of the job currently executing, RMS_IDLE_INDEX when none is.
+ * Safe to call from any context, fault handlers included. */
+uint8_t RMS_GetRunningThread(void);
+
+#if !RMS_PREEMPTIVE && !RMS_HW_RATE_GROUPS
+/* Cooperative dispatch: run the highest-priority ready job to completion.
+ * Returns false when no thread is ready. */
+bool RMS_DispatchNext(void);
+#endif
+
+#if !RMS_TICKLESS && !RMS_HW_RATE_GROUPS
+/* Called by Thd_idle on every pass when it does not sleep. Weak and empty; the host
+ * simulation overrides it to move simulated time on to the next release. */
+void RMS_IdleHook(void);
+#endif
+
+#if RMS_SPORADIC
+/* Post event bits to the sporadic server ThreadTable[index]. It is released at once if
+ * it is idle and has budget left, otherwise on completion or replenishment. Callable
+ * from thread context and from ISRs at or below RMS_CEILING_TICK priority. */
+void RMS_SporadicPost(uint8_t index, uint32_t events);
+
+/* From the server's handler: fetch and clear the posted event bits. */
+uint32_t RMS_SporadicTake(uint8_t index);
+#endif
+
+#if RMS_MIXED_CRIT
+/* Ask for a mode, applied at the next hyperperiod boundary. RMS_MODE_OVERLOAD stays
+ * in force while requested; a miss-triggered overload still holds after a request
+ * for RMS_MODE_NORMAL. Callable from any context. false = no such mode. */
+bool RMS_RequestMode(uint8_t mode);
+
+/* Mode whose release table currently runs, and the number of switches so far. */
+uint8_t RMS_GetMode(void);
+uint32_t RMS_GetModeSwitches(void);
+#endif
+
+/* Ticks between releases of ThreadTable[index] in the current mode, rate divider
+ * included; 0 for a thread shed by the mode. */
+uint32_t RMS_GetThreadPeriod(uint8_t index);
+
+/* Deadline misses of ThreadTable[index] since start. */
+uint32_t RMS_GetDeadlineMisses(uint8_t index);
+
+/* Current rate divider of ThreadTable[index] (1 = full rate). */
+uint8_t RMS_GetRateDivider(uint8_t index);
+
+/* Ticks elapsed since the scheduler started, updated by every PIT interrupt. */
+uint32_t RMS_GetSystemTick(void);
+
+/* Rate-monotonic analysis of ThreadTable using ThreadRate and ThreadWcetUs.
+ * Computes utilization against the Liu & Layland bound and the exact worst-case
+ * response time of every thread (deadline = period), in every mode. With cooperative
+ * dispatch a release also waits out the longest lower-priority job (blocking). Prints one
+ * block per mode: its release schedule, then the analysis. Returns the index of the
+ * first thread that misses its deadline, or RMS_SCHEDULABLE. */
+uint8_t RMS_CheckSchedulability(void);
+
+/* Worst-case response time of ThreadTable[index] from the last analysis, over all
+ * modes (microseconds). */
+uint32_t RMS_GetResponseTimeUs(uint8_t index);
+
+#if RMS_STATS
+/* Per-thread timing statistics, all values in core clock cycles */
+typedef struct{
+	uint32_t ExecMin;		/* Shortest job, dispatch to completion (includes preemption) */
+	uint32_t ExecMax;		/* Longest job */
+	uint64_t ExecSum;
+	uint32_t LatencyMin;	/* Shortest release-to-start delay */
+	uint32_t LatencyMax;	/* Longest release-to-start delay */
+	uint64_t LatencySum;
+	uint32_t Jobs;			/* Completed jobs */
+	uint32_t Overruns;		/* Jobs that completed after their next release was due */
+	uint32_t ReleaseCycle;	/* CYCCNT when the tick marked the thread READY */
+	uint32_t StartCycle;	/* CYCCNT when the current job was dispatched */
+	uint32_t DeadlineCycle;	/* CYCCNT when the current job's next release is due */
+}ThdStats;
+
+extern ThdStats ThreadStats[];
+
+/* Average execution and release-to-start cycles of ThreadTable[index] (0 before the first job). */
+uint32_t RMS_GetAvgExecCycles(uint8_t index);
+uint32_t RMS_GetAvgLatencyCycles(uint8_t index);
+
+/* From ThreadTable[index]'s own job: budget (ThreadWcetUs) left since the job was
+ * dispatched, in microseconds; 0 once it is used up. */
+uint32_t RMS_GetJobSlackUs(uint8_t index);
+
+/* Bitmap (RMS_READY_BIT layout) of threads whose measured ExecMax exceeds ThreadWcetUs,
+ * i.e. whose budget used in RMS_CheckSchedulability() is too optimistic. */
+uint32_t RMS_CheckBudgets(void);
+#endif
+
+#endif /* RMS_H_ */
@@ -0,0 +1,145 @@
+/**
+ * @file    RTT.c
+ *
+ * @brief Implementation of the RTT ring-buffer log backend.
+ */
+
+#include "RTT.h"
+#include "NVIC.h"
+#include "MK64F12.h"
+#include <string.h>
+
+static char s_upBuffer[RTT_UP_BUFFER_SIZE];
+static char s_downBuffer[RTT_DOWN_BUFFER_SIZE];
+static uint32_t s_dropped = 0U;
+
+rtt_control_block_t _SEGGER_RTT;
+
+void RTT_Init(void){
+    static const char id[] = "SEGGER RTT";
+    rtt_control_block_t *cb = &_SEGGER_RTT;
+    uint32_t i;
+
+    if (cb->acID[0] == 'S'){
+        return;
+    }
+
+    cb->MaxNumUpBuffers   = 1;
+    cb->MaxNumDownBuffers = 1;
+
+    cb->aUp[0].sName        = "Terminal";
+    cb->aUp[0].pBuffer      = s_upBuffer;
+    cb->aUp[0].SizeOfBuffer = RTT_UP_BUFFER_SIZE;
+    cb->aUp[0].WrOff        = 0U;
+    cb->aUp[0].RdOff        = 0U;
+    cb->aUp[0].Flags        = RTT_MODE_NO_BLOCK_TRIM;
+
+    cb->aDown[0].sName        = "Terminal";
+    cb->aDown[0].pBuffer      = s_downBuffer;
+    cb->aDown[0].SizeOfBuffer = RTT_DOWN_BUFFER_SIZE;
+    cb->aDown[0].WrOff        = 0U;
+    cb->aDown[0].RdOff        = 0U;
+    cb->aDown[0].Flags        = RTT_MODE_NO_BLOCK_SKIP;
+
+    /* The probe may be scanning already: publish the ID only once the block is
+     * complete, first character last, so it is never matched half-written */
+    __DMB();
+    for (i = sizeof(id) - 1U; i > 0U; i--){
+        cb->acID[i] = id[i];
+    }
+    __DMB();
+    cb->acID[0] = id[0];
+}
+
+uint32_t RTT_Write(const void *data, uint32_t len){
+    rtt_buffer_t *up = &_SEGGER_RTT.aUp[0];
+    const char *src = (const char *)data;
+    nvic_critical_t crit;
+    uint32_t wr, rd, space, n, first;
+
+    if (_SEGGER_RTT.acID[0] != 'S'){
+        RTT_Init();
+    }
+
+    crit = NVIC_enter_critical(RTT_CEILING_WRITE);
+    wr = up->WrOff;
+    rd = up->RdOff;
+    /* One slot stays empty so that WrOff == RdOff always means "empty" */
+    space = (rd > wr) ? (rd - wr - 1U) : (up->SizeOfBuffer - wr + rd - 1U);
+    n = (len < space) ? len : space;
+    s_dropped += len - n;
+
+    first = up->SizeOfBuffer - wr;
+    if (first > n){
+        first = n;
+    }
+    memcpy(&up->pBuffer[wr], src, first);
+    memcpy(&up->pBuffer[0], &src[first], n - first);
+
+    wr += n;
+    if (wr >= up->SizeOfBuffer){
+        wr -= up->SizeOfBuffer;
+    }
+    /* Data must be visible to the probe before the new write offset */
+    __DMB();
+    up->WrOff = wr;
+    NVIC_exit_critical(crit);
+    return n;
+}
+
+uint32_t RTT_Pending(void){
+    const rtt_buffer_t *up = &_SEGGER_RTT.aUp[0];
+    uint32_t wr = up->WrOff;
+    uint32_t rd = up->RdOff;
+
+    return (wr >= rd) ? (wr - rd) : (up->SizeOfBuffer - rd + wr);
+}
+
+uint32_t RTT_Read(void *dst, uint32_t max){
+    rtt_buffer_t *down = &_SEGGER_RTT.aDown[0];
+    char *out = (char *)dst;
+    uint32_t rd = down->RdOff;
+    uint32_t wr = down->WrOff;
+    uint32_t n = 0U;
+
+    if (_SEGGER_RTT.acID[0] != 'S'){
+        return 0U;
+    }
+    __DMB();
+    while ((rd != wr) && (n < max)){
+        out[n++] = down->pBuffer[rd];
+        rd = ((rd + 1U) == down->SizeOfBuffer) ? 0U : (rd + 1U);
+    }
+    __DMB();
+    down->RdOff = rd;
+    return n;
+}
+
+uint32_t RTT_GetDropped(void){
+    return s_dropped;
+}
+
+#if RTT_LOG
+/* ================= C library retarget ================= */
+
+/* Output that does not fit is dropped but reported as written: a short count would
+ * make the library retry, i.e. block until the probe drains the ring. */
+
+/* newlib / newlib-nano: bytes written */
+int _write(int fd, const char *buf, int len){
+    (void)fd;
+    if (len > 0){
+        (void)RTT_Write(buf, (uint32_t)len);
+    }
+    return len;
+}
+
+/* Redlib (nohost): bytes NOT written */
+int __sys_write(int fd, char *buf, int len){
+    (void)fd;
+    if (len > 0){
+        (void)RTT_Write(buf, (uint32_t)len);
+    }
+    return 0;
+}
+#endif /* RTT_LOG */
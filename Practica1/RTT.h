@@ -0,0 +1,80 @@
+/**
+ * @file    RTT.h
+ *
+ * @brief Non-blocking log output through a RAM ring buffer read by the debug probe.
+ *
+ * The control block follows the SEGGER RTT layout and is named _SEGGER_RTT, so J-Link
+ * (RTT Viewer, `monitor rtt`), pyOCD and OpenOCD find it by symbol or by scanning RAM
+ * for its ID. The probe drains up-buffer 0 in the background through the debug
+ * port while the core keeps running: a write is a bounded copy into RAM and never
+ * halts the CPU, unlike semihosting. When the buffer is full the excess is dropped
+ * and counted (no blocking).
+ *
+ * With RTT_LOG=1 the C library write hooks (_write for newlib, __sys_write for
+ * Redlib) land here, so PRINTF keeps working underneath fsl_debug_console when it
+ * redirects to the toolchain; link the library's "nohost" variant. With RTT_LOG=0
+ * the semihosting library stays in charge, as before.
+ */
+
+#ifndef RTT_H_
+#define RTT_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Build option: 1 = console output goes to the RTT ring, 0 = semihosting */
+#ifndef RTT_LOG
+#define RTT_LOG                 0
+#endif
+
+#ifndef RTT_UP_BUFFER_SIZE
+#define RTT_UP_BUFFER_SIZE      1024U   /* Target -> probe (log) */
+#endif
+#ifndef RTT_DOWN_BUFFER_SIZE
+#define RTT_DOWN_BUFFER_SIZE    16U     /* Probe -> target (input) */
+#endif
+
+/* BASEPRI ceiling of the up-buffer: the highest priority that may log. Tick and
+ * rate-group ISRs included; PRIORITY_0 handlers must not log. */
+#define RTT_CEILING_WRITE       PRIORITY_1
+
+/* SEGGER buffer flags: what the target does when the ring is full */
+#define RTT_MODE_NO_BLOCK_SKIP  0U      /* Drop the whole write */
+#define RTT_MODE_NO_BLOCK_TRIM  1U      /* Write what fits, drop the rest */
+
+/* One ring. The probe writes RdOff of up-buffers and WrOff of down-buffers. */
+typedef struct {
+    const char        *sName;
+    char              *pBuffer;
+    uint32_t           SizeOfBuffer;
+    volatile uint32_t  WrOff;
+    volatile uint32_t  RdOff;
+    uint32_t           Flags;
+} rtt_buffer_t;
+
+typedef struct {
+    char         acID[16];          /* "SEGGER RTT", written last by RTT_Init() */
+    int32_t      MaxNumUpBuffers;
+    int32_t      MaxNumDownBuffers;
+    rtt_buffer_t aUp[1];
+    rtt_buffer_t aDown[1];
+} rtt_control_block_t;
+
+extern rtt_control_block_t _SEGGER_RTT;
+
+/* Set up the control block. Safe to call more than once; writes call it lazily. */
+void RTT_Init(void);
+
+/* Copy up to `len` bytes into the up-buffer; returns the number written. */
+uint32_t RTT_Write(const void *data, uint32_t len);
+
+/* Bytes currently waiting for the probe. */
+uint32_t RTT_Pending(void);
+
+/* Copy up to `max` bytes sent by the probe into dst; returns the number read. */
+uint32_t RTT_Read(void *dst, uint32_t max);
+
+/* Bytes dropped because the up-buffer was full. */
+uint32_t RTT_GetDropped(void);
+
+#endif /* RTT_H_ */
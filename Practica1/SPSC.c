@@ -0,0 +1,73 @@
+/**
+ * @file    SPSC.c
+ *
+ * @brief Implementation of the lock-free SPSC ring buffer.
+ */
+
+#include "SPSC.h"
+#include <string.h>
+
+bool SPSC_Init(spsc_queue_t *q, void *storage, uint32_t capacity, uint16_t elemSize){
+    if ((capacity == 0U) || ((capacity & (capacity - 1U)) != 0U)){
+        return false;
+    }
+    q->buf      = (uint8_t *)storage;
+    q->mask     = capacity - 1U;
+    q->elemSize = elemSize;
+    q->head     = 0U;
+    q->tail     = 0U;
+    q->drops    = 0U;
+    return true;
+}
+
+bool SPSC_Push(spsc_queue_t *q, const void *item){
+    uint32_t head = q->head;
+
+    if ((head - q->tail) > q->mask){
+        q->drops++;
+        return false;
+    }
+    memcpy(&q->buf[(head & q->mask) * q->elemSize], item, q->elemSize);
+
+    /* Slot contents must be visible before the consumer can see the new head */
+    __DMB();
+    q->head = head + 1U;
+    return true;
+}
+
+bool SPSC_Pop(spsc_queue_t *q, void *item){
+    uint32_t tail = q->tail;
+
+    if (q->head == tail){
+        return false;
+    }
+    /* Read the slot only after observing the head that published it */
+    __DMB();
+    memcpy(item, &q->buf[(tail & q->mask) * q->elemSize], q->elemSize);
+
+    /* Finish reading before handing the slot back to the producer */
+    __DMB();
+    q->tail = tail + 1U;
+    return true;
+}
+
+uint32_t SPSC_PopBatch(spsc_queue_t *q, void *dst, uint32_t max){
+    uint32_t tail  = q->tail;
+    uint32_t avail = q->head - tail;
+    uint8_t *out   = (uint8_t *)dst;
+    uint32_t i;
+
+    if (avail > max){
+        avail = max;
+    }
+    if (avail == 0U){
+        return 0U;
+    }
+    __DMB();
+    for (i = 0U; i < avail; i++){
+        memcpy(&out[i * q->elemSize], &q->buf[((tail + i) & q->mask) * q->elemSize], q->elemSize);
+    }
+    __DMB();
+    q->tail = tail + avail;
+    return avail;
+}
@@ -0,0 +1,52 @@
+/**
+ * @file    SPSC.h
+ *
+ * @brief Lock-free single-producer/single-consumer ring buffer.
+ *
+ * One context (typically an ISR) pushes and exactly one other context (typically
+ * an RMS thread) pops. head is written only by the producer and tail only by the
+ * consumer, so no interrupt masking is needed: each side publishes its index with
+ * a data memory barrier after touching the slot. Both indexes run free and wrap
+ * naturally; the capacity must be a power of two so a slot is (index & mask).
+ */
+
+#ifndef SPSC_H_
+#define SPSC_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "MK64F12.h"
+
+typedef struct {
+    uint8_t          *buf;          /* capacity * elemSize bytes of storage */
+    uint32_t          mask;         /* capacity - 1 */
+    uint16_t          elemSize;     /* Bytes per element */
+    volatile uint32_t head;         /* Next slot to write (producer only) */
+    volatile uint32_t tail;         /* Next slot to read (consumer only) */
+    volatile uint32_t drops;        /* Pushes rejected because the ring was full */
+} spsc_queue_t;
+
+/* Attach storage of `capacity` elements of `elemSize` bytes. Returns false when
+ * capacity is not a power of two. Call before either side runs. */
+bool SPSC_Init(spsc_queue_t *q, void *storage, uint32_t capacity, uint16_t elemSize);
+
+/* Producer: copy one element in. Returns false (and counts a drop) when full. */
+bool SPSC_Push(spsc_queue_t *q, const void *item);
+
+/* Consumer: copy the oldest element out. Returns false when empty. */
+bool SPSC_Pop(spsc_queue_t *q, void *item);
+
+/* Consumer: pop up to `max` elements into dst; returns the number copied. */
+uint32_t SPSC_PopBatch(spsc_queue_t *q, void *dst, uint32_t max);
+
+/* Elements currently queued (exact from the consumer, a lower bound from the producer). */
+static inline uint32_t SPSC_Count(const spsc_queue_t *q){
+    return q->head - q->tail;
+}
+
+/* Pushes lost since init (producer-side count). */
+static inline uint32_t SPSC_GetDrops(const spsc_queue_t *q){
+    return q->drops;
+}
+
+#endif /* SPSC_H_ */
@@ -0,0 +1,205 @@
+/**
+ * @file    STACK.c
+ *
+ * @brief Implementation of the stack monitor and the SYSMPU stack guards.
+ */
+
+#include "STACK.h"
+
+#if STACK_MONITOR
+#include "MK64F12.h"
+#include "fsl_clock.h"
+#include "fsl_debug_console.h"
+
+/* MSP stack bounds from the MCUXpresso linker script */
+extern uint32_t _vStackBase[];
+extern uint32_t _vStackTop[];
+
+/* Words left alone under the live frame when the MSP stack is painted in place */
+#define STACK_PAINT_MARGIN_WORDS    32U
+
+#if STACK_GUARD
+/* Region descriptors in the K64 SYSMPU */
+#define STACK_MPU_REGIONS           12U
+/* Access rights (RGDn_WORD2). Masters 0..3 have a 6-bit field: UM (user r/w/x) in
+ * bits 2:0, SM in bits 4:3 (00 = supervisor rwx, 11 = same as UM), PE in bit 5.
+ * Bus masters 0 and 1 are the core code and system buses. The core always runs
+ * privileged, so it is only shut out of a region with SM = 11 and UM = 000. */
+#define STACK_MPU_SM_AS_USER        (0x3UL << 3)
+#define STACK_MPU_UM_RWX            0x7UL
+#define STACK_MPU_CORE_FIELDS       ((0x3FUL << 0) | (0x3FUL << 6))
+/* Core regions: user rwx, supervisor as user */
+#define STACK_MPU_CORE              (((STACK_MPU_SM_AS_USER | STACK_MPU_UM_RWX) << 0) | \
+                                     ((STACK_MPU_SM_AS_USER | STACK_MPU_UM_RWX) << 6))
+/* Region 0: no access for the core; masters 2 and 3 rwx, masters 4..7 read/write */
+#define STACK_MPU_CORE_NONE         ((STACK_MPU_SM_AS_USER << 0) | (STACK_MPU_SM_AS_USER << 6))
+#define STACK_MPU_OTHERS            (STACK_MPU_CORE_NONE | (0x07UL << 12) | (0x07UL << 18) | (0xFFUL << 24))
+
+_Static_assert((STACK_MAX_STACKS + 2U) <= STACK_MPU_REGIONS,
+               "every guard splits a core region: region 0, one gap per guard and the last one");
+#endif
+
+typedef struct {
+    const char *name;
+    uint32_t   *bottom;     /* First usable word, above the guard */
+    uint32_t   *top;        /* One past the highest word */
+    uint32_t    guard;      /* Guard start address (STACK_GUARD_BYTES-aligned) */
+    uint32_t    peak;       /* Bytes used, from the last scan */
+} stack_info_t;
+
+static stack_info_t s_stacks[STACK_MAX_STACKS];
+static uint8_t  s_count = 0U;
+static uint8_t  s_next = 0U;        /* Stack measured by the next scan */
+static uint32_t s_lastScan = 0U;
+
+static void STACK_Paint(uint32_t *from, const uint32_t *to){
+    while (from < to){
+        *from++ = STACK_PAINT;
+    }
+}
+
+/* Registry entry for [base, top); the guard comes off the bottom */
+static uint8_t STACK_Add(const char *name, uint32_t *base, uint32_t *top){
+    uint32_t guard = ((uint32_t)(uintptr_t)base + STACK_GUARD_BYTES - 1U) & ~(STACK_GUARD_BYTES - 1U);
+    stack_info_t *st;
+
+    if (s_count >= STACK_MAX_STACKS){
+        return STACK_NONE;
+    }
+    st = &s_stacks[s_count];
+    st->name   = name;
+    st->guard  = guard;
+    st->bottom = STACK_GUARD ? (uint32_t *)(uintptr_t)(guard + STACK_GUARD_BYTES) : base;
+    st->top    = top;
+    st->peak   = 0U;
+    if (st->bottom >= top){
+        return STACK_NONE;
+    }
+    return s_count++;
+}
+
+void STACK_Init(void){
+    uint32_t *live = (uint32_t *)(uintptr_t)__get_MSP() - STACK_PAINT_MARGIN_WORDS;
+
+    if (STACK_Add("msp", _vStackBase, _vStackTop) == STACK_MSP){
+        STACK_Paint(s_stacks[STACK_MSP].bottom, live);
+    }
+}
+
+uint8_t STACK_Register(const char *name, uint32_t *base, uint32_t words){
+    uint8_t id = STACK_Add(name, base, base + words);
+
+    if (id != STACK_NONE){
+        STACK_Paint(s_stacks[id].bottom, s_stacks[id].top);
+    }
+    return id;
+}
+
+#if STACK_GUARD
+static void STACK_SetRegion(uint32_t region, uint32_t start, uint32_t end){
+    SYSMPU->WORD[region][0] = start;
+    SYSMPU->WORD[region][1] = end;
+    SYSMPU->WORD[region][2] = STACK_MPU_CORE;
+    SYSMPU->WORD[region][3] = SYSMPU_WORD_VLD_MASK;
+}
+
+bool STACK_EnableGuards(void){
+    uint8_t order[STACK_MAX_STACKS];
+    uint32_t start = 0U;
+    uint32_t region = 1U;
+    uint8_t i, j;
+
+    /* Guards in address order, so the gaps between them can be walked once */
+    for (i = 0U; i < s_count; i++){
+        for (j = i; (j > 0U) && (s_stacks[order[j - 1U]].guard > s_stacks[i].guard); j--){
+            order[j] = order[j - 1U];
+        }
+        order[j] = i;
+    }
+
+    CLOCK_EnableClock(kCLOCK_Sysmpu0);
+    SYSMPU->CESR = 0U;      /* Off while the map is incomplete */
+
+    /* The core gets everything except the guards */
+    for (i = 0U; i < s_count; i++){
+        uint32_t guard = s_stacks[order[i]].guard;
+
+        if (guard > start){
+            STACK_SetRegion(region++, start, guard - 1U);
+        }
+        start = guard + STACK_GUARD_BYTES;
+    }
+    STACK_SetRegion(region++, start, 0xFFFFFFFFUL);
+    for (; region < STACK_MPU_REGIONS; region++){
+        SYSMPU->WORD[region][3] = 0U;
+    }
+
+    /* Region 0 spans the whole map and any region granting access wins: it must stay
+     * for the other masters only, or it covers every guard */
+    SYSMPU->RGDAAC[0] = STACK_MPU_OTHERS;
+    SYSMPU->CESR = SYSMPU_CESR_VLD_MASK;
+    __DSB();
+    __ISB();
+
+    /* Read back: if region 0 still lets the core in, no guard can ever fire */
+    return (SYSMPU->WORD[0][2] & STACK_MPU_CORE_FIELDS) == (STACK_MPU_CORE_NONE & STACK_MPU_CORE_FIELDS);
+}
+
+uint8_t STACK_GuardOwner(uint32_t address){
+    uint8_t i;
+
+    for (i = 0U; i < s_count; i++){
+        if ((address - s_stacks[i].guard) < STACK_GUARD_BYTES){
+            return i;
+        }
+    }
+    return STACK_NONE;
+}
+
+uint32_t STACK_GetGuard(uint8_t id){
+    return (id < s_count) ? s_stacks[id].guard : 0U;
+}
+#endif /* STACK_GUARD */
+
+void STACK_Scan(uint32_t tick){
+    stack_info_t *st;
+    const volatile uint32_t *word;
+
+    if ((s_count == 0U) || ((uint32_t)(tick - s_lastScan) < STACK_SCAN_TICKS)){
+        return;
+    }
+    s_lastScan = tick;
+    st = &s_stacks[s_next];
+    s_next = ((s_next + 1U) == s_count) ? 0U : (uint8_t)(s_next + 1U);
+
+    /* Stacks grow down: the first overwritten word from the bottom is the deepest use */
+    word = st->bottom;
+    while ((word < st->top) && (*word == STACK_PAINT)){
+        word++;
+    }
+    st->peak = (uint32_t)((uintptr_t)st->top - (uintptr_t)word);
+}
+
+uint32_t STACK_GetSize(uint8_t id){
+    return (id < s_count) ? (uint32_t)((uintptr_t)s_stacks[id].top - (uintptr_t)s_stacks[id].bottom) : 0U;
+}
+
+uint32_t STACK_GetPeak(uint8_t id){
+    return (id < s_count) ? s_stacks[id].peak : 0U;
+}
+
+uint8_t STACK_GetCount(void){
+    return s_count;
+}
+
+void STACK_Report(void){
+    uint8_t i;
+
+    for (i = 0U; i < s_count; i++){
+        PRINTF("\r\nSTACK %u: %s %u bytes, peak %u, free %u", (unsigned)i, s_stacks[i].name,
+               (unsigned)STACK_GetSize(i), (unsigned)s_stacks[i].peak,
+               (unsigned)(STACK_GetSize(i) - s_stacks[i].peak));
+    }
+}
+
+#endif /* STACK_MONITOR */
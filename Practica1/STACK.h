@@ -0,0 +1,90 @@
+/**
+ * @file    STACK.h
+ *
+ * @brief Stack painting, high-water marks and SYSMPU overflow guards.
+ *
+ * Every monitored stack (the MSP stack, and one per thread with RMS_PREEMPTIVE) is
+ * filled with STACK_PAINT at boot. Thd_idle calls STACK_Scan(), which every
+ * STACK_SCAN_TICKS measures one stack by counting untouched words from its bottom
+ * up, so the high-water mark is the deepest use since boot.
+ *
+ * With STACK_GUARD=1 the lowest STACK_GUARD_BYTES of every stack become a hole in
+ * the SYSMPU map (the K64 core has no ARMv7-M MPU, the crossbar SYSMPU checks it
+ * instead). Region 0 keeps serving the DMA-capable masters but no longer the core;
+ * the core is given regions covering everything between the guards. A push into a
+ * guard is a bus error, which escalates to HardFault and is recorded by CRASH_Capture
+ * together with the SYSMPU error address and the stack it belongs to. The fault
+ * handler moves to its own stack first (semihost_hardfault.c) so that a frame pushed
+ * into the MSP guard does not fault again; RMS_BENCH checks that the MSP guard traps
+ * (BENCH.h), the capture of a real MSP overflow has not been exercised on target.
+ * Guards must lie in SRAM_U/flash, where the crossbar sees the core.
+ *
+ * The MSP stack is taken from the MCUXpresso linker symbols _vStackBase/_vStackTop.
+ * Interrupts all run on it; NVIC_PROFILE adds the MSP depth seen at each handler's
+ * entry (nvic_irq_profile_t.StackMin), i.e. per IRQ and priority level.
+ */
+
+#ifndef STACK_H_
+#define STACK_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Build option: 1 = paint and measure the stacks, 0 = no monitoring */
+#ifndef STACK_MONITOR
+#define STACK_MONITOR           0
+#endif
+
+/* Build option: 1 = SYSMPU guard below every monitored stack */
+#ifndef STACK_GUARD
+#define STACK_GUARD             STACK_MONITOR
+#endif
+#if STACK_GUARD && !STACK_MONITOR
+#error "STACK_GUARD: the guarded stacks are the ones registered with STACK_MONITOR"
+#endif
+
+#define STACK_PAINT             0xA5A5A5A5UL
+#define STACK_GUARD_BYTES       32U     /* SYSMPU region granularity */
+#define STACK_SCAN_TICKS        100U    /* Ticks between two stack scans */
+#define STACK_MAX_STACKS        10U     /* Guards, with region 0 and the last gap: 12 GDs */
+#define STACK_MSP               0U      /* Id of the MSP stack */
+#define STACK_NONE              0xFFU
+
+/* Paint the unused part of the MSP stack and register it as STACK_MSP. Call early in
+ * main, with interrupts still disabled. */
+void STACK_Init(void);
+
+/* Paint and register a stack of `words` words at `base` (lowest address), before it
+ * is used. With STACK_GUARD the first STACK_GUARD_BYTES-aligned block is the guard,
+ * so the stack should be allocated 32-byte aligned. Returns the id, or STACK_NONE
+ * when the registry is full. The name is kept, not copied. */
+uint8_t STACK_Register(const char *name, uint32_t *base, uint32_t words);
+
+#if STACK_GUARD
+/* Program the SYSMPU with a guard under every registered stack. Call once, after the
+ * last STACK_Register() and before the scheduler starts. Returns false when the
+ * read-back shows region 0 still granting the core access (guards inactive). */
+bool STACK_EnableGuards(void);
+
+/* Id of the stack whose guard contains `address`, STACK_NONE if none (fault context). */
+uint8_t STACK_GuardOwner(uint32_t address);
+
+/* Start address of a stack's guard, 0 for an unknown id. */
+uint32_t STACK_GetGuard(uint8_t id);
+#endif
+
+/* Measure one stack if STACK_SCAN_TICKS have passed since the last one. Lowest
+ * priority only: Thd_idle calls it. */
+void STACK_Scan(uint32_t tick);
+
+/* Usable bytes of a stack (guard excluded) and the most ever used, from the last scan. */
+uint32_t STACK_GetSize(uint8_t id);
+uint32_t STACK_GetPeak(uint8_t id);
+
+/* Number of registered stacks. */
+uint8_t STACK_GetCount(void);
+
+/* Print size, peak and headroom of every stack. */
+void STACK_Report(void);
+
+#endif /* STACK_H_ */
@@ -0,0 +1,110 @@
+/**
+ * @file    TELEMETRY.c
+ *
+ * @brief Implementation of the double-buffered UART/eDMA telemetry stream.
+ */
+
+#include "TELEMETRY.h"
+#include "fsl_uart.h"
+#include "fsl_uart_edma.h"
+#include "fsl_edma.h"
+#include "fsl_dmamux.h"
+#include <stddef.h>
+
+#define TELEMETRY_HEADER_BYTES  offsetof(telemetry_frame_t, tick)
+
+_Static_assert(sizeof(telemetry_frame_t) - TELEMETRY_HEADER_BYTES <= 0xFFU,
+               "telemetry payload must fit the 8-bit length field");
+
+static telemetry_frame_t  s_frame[2];
+static uint8_t            s_fill = 0U;      /* Buffer handed out by TELEMETRY_Acquire() */
+static uint8_t            s_seq  = 0U;
+static volatile bool      s_busy = false;
+static uint32_t           s_drops = 0U;
+
+static uart_edma_handle_t s_uartHandle;
+static edma_handle_t      s_txDmaHandle;
+
+/* eDMA major loop done: the whole frame has been written to the UART. */
+static void TELEMETRY_TxDone(UART_Type *base, uart_edma_handle_t *handle,
+                             status_t status, void *userData){
+    (void)base;
+    (void)handle;
+    (void)userData;
+
+    if (status == kStatus_UART_TxIdle){
+        s_busy = false;
+    }
+}
+
+void TELEMETRY_Init(void){
+    uart_config_t uartCfg;
+    edma_config_t dmaCfg;
+
+    UART_GetDefaultConfig(&uartCfg);
+    uartCfg.baudRate_Bps = TELEMETRY_BAUD_RATE;
+    uartCfg.enableTx     = true;
+    uartCfg.enableRx     = false;
+    UART_Init(TELEMETRY_UART, &uartCfg, TELEMETRY_UART_CLK_FREQ);
+
+    DMAMUX_Init(DMAMUX0);
+    DMAMUX_SetSource(DMAMUX0, TELEMETRY_DMA_CHANNEL, TELEMETRY_DMA_REQUEST);
+    DMAMUX_EnableChannel(DMAMUX0, TELEMETRY_DMA_CHANNEL);
+
+    EDMA_GetDefaultConfig(&dmaCfg);
+    EDMA_Init(DMA0, &dmaCfg);
+    EDMA_CreateHandle(&s_txDmaHandle, DMA0, TELEMETRY_DMA_CHANNEL);
+    UART_TransferCreateHandleEDMA(TELEMETRY_UART, &s_uartHandle, TELEMETRY_TxDone, NULL,
+                                  &s_txDmaHandle, NULL);
+
+    s_fill  = 0U;
+    s_seq   = 0U;
+    s_busy  = false;
+    s_drops = 0U;
+
+    /* TELEMETRY_DMA_IRQ itself is enabled by NVIC_init() */
+}
+
+telemetry_frame_t *TELEMETRY_Acquire(void){
+    return &s_frame[s_fill];
+}
+
+bool TELEMETRY_Submit(telemetry_frame_t *frame){
+    uart_transfer_t xfer;
+    uint8_t count = (frame->threadCount > TELEMETRY_MAX_THREADS) ?
+                    (uint8_t)TELEMETRY_MAX_THREADS : frame->threadCount;
+
+    if (s_busy){
+        s_drops++;
+        return false;
+    }
+
+    frame->sync[0]     = TELEMETRY_SYNC0;
+    frame->sync[1]     = TELEMETRY_SYNC1;
+    frame->seq         = s_seq++;
+    frame->threadCount = count;
+    frame->length      = (uint8_t)(offsetof(telemetry_frame_t, thread) - TELEMETRY_HEADER_BYTES +
+                                   count * sizeof(telemetry_thread_t));
+
+    xfer.data     = (uint8_t *)frame;
+    xfer.dataSize = TELEMETRY_HEADER_BYTES + frame->length;
+
+    s_busy = true;
+    if (UART_SendEDMA(TELEMETRY_UART, &s_uartHandle, &xfer) != kStatus_Success){
+        s_busy = false;
+        s_drops++;
+        return false;
+    }
+
+    /* The eDMA now owns this buffer; the next frame is built in the other one */
+    s_fill ^= 1U;
+    return true;
+}
+
+bool TELEMETRY_IsBusy(void){
+    return s_busy;
+}
+
+uint32_t TELEMETRY_GetDrops(void){
+    return s_drops;
+}
@@ -0,0 +1,74 @@
+/**
+ * @file    TELEMETRY.h
+ *
+ * @brief Binary telemetry frames streamed over UART by eDMA.
+ *
+ * Frames are filled in place in one of two static buffers while the other one is
+ * being shifted out by the eDMA, so the CPU only writes the frame fields and never
+ * feeds the UART byte by byte. A frame submitted while the previous one is still
+ * in flight is dropped (and counted) instead of blocking the caller.
+ *
+ * Wire format (little-endian, packed):
+ *   0xA5 0x5A | seq | length | payload[length]
+ * where the payload is telemetry_frame_t from `tick` up to thread[threadCount].
+ */
+
+#ifndef TELEMETRY_H_
+#define TELEMETRY_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "fsl_common.h"
+
+/* -------- Link selection -------- */
+#define TELEMETRY_UART              UART0       /* Shared with the debug console */
+#define TELEMETRY_UART_CLK_FREQ     CLOCK_GetFreq(kCLOCK_CoreSysClk)
+#define TELEMETRY_BAUD_RATE         115200U
+#define TELEMETRY_DMA_CHANNEL       1U          /* Channel 0 belongs to the ADC ring */
+#define TELEMETRY_DMA_REQUEST       kDmaRequestMux0UART0Tx
+#define TELEMETRY_DMA_IRQ           DMA_CH1_IRQ
+#define TELEMETRY_DMA_IRQ_PRIORITY  PRIORITY_4
+
+#define TELEMETRY_SYNC0             0xA5U
+#define TELEMETRY_SYNC1             0x5AU
+#define TELEMETRY_MAX_THREADS       8U
+
+/* Per-thread timing, core clock cycles (zeros when RMS_STATS is off) */
+typedef struct __attribute__((packed)) {
+    uint32_t execAvgCycles;
+    uint32_t execMaxCycles;
+    uint32_t latencyMaxCycles;
+    uint32_t jobs;
+    uint32_t overruns;
+} telemetry_thread_t;
+
+typedef struct __attribute__((packed)) {
+    uint8_t  sync[2];           /* Filled by TELEMETRY_Submit() */
+    uint8_t  seq;               /* Filled by TELEMETRY_Submit() */
+    uint8_t  length;            /* Filled by TELEMETRY_Submit() */
+    uint32_t tick;              /* Scheduler tick of the snapshot */
+    uint16_t tempDeci;          /* Last sample, tenths of °C */
+    uint16_t avgTempDeci;       /* Rolling average, tenths of °C */
+    uint16_t filteredTempDeci;  /* Selected filter output, tenths of °C */
+    uint8_t  threadCount;       /* Valid entries in thread[] */
+    uint8_t  reserved;
+    telemetry_thread_t thread[TELEMETRY_MAX_THREADS];
+} telemetry_frame_t;
+
+/* Configure the UART and its eDMA TX channel. Call once before any submit. */
+void TELEMETRY_Init(void);
+
+/* Buffer to fill for the next frame. It is never the one the eDMA is reading. */
+telemetry_frame_t *TELEMETRY_Acquire(void);
+
+/* Stamp the header of a frame from TELEMETRY_Acquire() and start its transfer.
+ * Returns false (frame dropped) while the previous frame is still on the wire. */
+bool TELEMETRY_Submit(telemetry_frame_t *frame);
+
+/* True while a frame is being transmitted. */
+bool TELEMETRY_IsBusy(void);
+
+/* Frames dropped because the link was still busy. */
+uint32_t TELEMETRY_GetDrops(void);
+
+#endif /* TELEMETRY_H_ */
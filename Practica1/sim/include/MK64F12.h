@@ -0,0 +1,144 @@
+/**
+ * @file    MK64F12.h
+ *
+ * @brief Host simulation stand-in for the K64 device header.
+ *
+ * Only what the Practica1 sources touch is modelled. Core peripherals are plain
+ * structs in host memory; DWT->CYCCNT reads the simulated core clock and the
+ * CMSIS intrinsics operate on simulated PRIMASK/BASEPRI state. Interrupts are
+ * delivered synchronously by the simulator (see sim.h), never asynchronously.
+ */
+
+#ifndef SIM_MK64F12_H_
+#define SIM_MK64F12_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define __NVIC_PRIO_BITS        4
+#define NUMBER_OF_INT_VECTORS   102
+#define __I                     volatile const
+#define __O                     volatile
+#define __IO                    volatile
+
+typedef enum {
+    NonMaskableInt_IRQn = -14, HardFault_IRQn = -13, MemoryManagement_IRQn = -12,
+    BusFault_IRQn = -11, UsageFault_IRQn = -10, SVCall_IRQn = -5, DebugMonitor_IRQn = -4,
+    PendSV_IRQn = -2, SysTick_IRQn = -1,
+    DMA0_IRQn = 0, DMA1_IRQn = 1, WDOG_EWM_IRQn = 22, UART0_RX_TX_IRQn = 31, ADC0_IRQn = 39,
+    PIT0_IRQn = 48, PIT1_IRQn = 49, PIT2_IRQn = 50, PIT3_IRQn = 51, PDB0_IRQn = 52,
+    PORTA_IRQn = 59, PORTB_IRQn = 60, PORTC_IRQn = 61, PORTD_IRQn = 62, PORTE_IRQn = 63,
+    ADC1_IRQn = 73
+} IRQn_Type;
+
+/* -------- Simulated core state (sim_periph.c) -------- */
+extern uint32_t SystemCoreClock;
+extern uint32_t sim_primask;
+extern uint32_t sim_basepri;
+extern uint32_t sim_ipsr;
+uint32_t sim_core_cycles32(void);
+void     sim_wfi(void);
+void     sim_irq_check(void);   /* Take whatever the new masks let through */
+
+/* -------- CMSIS core intrinsics -------- */
+static inline void __DSB(void){ __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+static inline void __ISB(void){ __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+static inline void __DMB(void){ __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+static inline void __NOP(void){ }
+static inline void __WFI(void){ sim_wfi(); }
+static inline uint32_t __CLZ(uint32_t x){ return (x != 0U) ? (uint32_t)__builtin_clz(x) : 32U; }
+/* Interrupts only arrive between simulated instructions the simulator controls,
+ * so an exclusive pair can never be broken */
+static inline uint32_t __LDREXW(volatile uint32_t *addr){ return *addr; }
+static inline uint32_t __STREXW(uint32_t value, volatile uint32_t *addr){ *addr = value; return 0U; }
+static inline void __CLREX(void){ }
+static inline void __disable_irq(void){ sim_primask = 1U; }
+static inline void __enable_irq(void){ sim_primask = 0U; sim_irq_check(); }
+static inline uint32_t __get_PRIMASK(void){ return sim_primask; }
+static inline void __set_PRIMASK(uint32_t value){ sim_primask = value & 1U; sim_irq_check(); }
+static inline uint32_t __get_BASEPRI(void){ return sim_basepri; }
+static inline void __set_BASEPRI(uint32_t value){ sim_basepri = value & 0xFFU; sim_irq_check(); }
+static inline void __set_BASEPRI_MAX(uint32_t value){
+    value &= 0xFFU;
+    if ((value != 0U) && ((sim_basepri == 0U) || (value < sim_basepri))){
+        sim_basepri = value;
+    }
+}
+static inline uint32_t __get_IPSR(void){ return sim_ipsr; }
+
+/* -------- NVIC (only the bookkeeping) -------- */
+extern uint8_t sim_nvic_priority[NUMBER_OF_INT_VECTORS];
+extern bool    sim_nvic_enabled[NUMBER_OF_INT_VECTORS];
+static inline void NVIC_SetPriority(IRQn_Type irq, uint32_t priority){
+    sim_nvic_priority[(int)irq + 16] = (uint8_t)priority;
+}
+static inline uint32_t NVIC_GetPriority(IRQn_Type irq){ return sim_nvic_priority[(int)irq + 16]; }
+static inline void NVIC_EnableIRQ(IRQn_Type irq){ sim_nvic_enabled[(int)irq + 16] = true; }
+static inline void NVIC_DisableIRQ(IRQn_Type irq){ sim_nvic_enabled[(int)irq + 16] = false; }
+static inline void EnableIRQ(IRQn_Type irq){ NVIC_EnableIRQ(irq); }
+
+/* -------- System control block, DWT -------- */
+typedef struct {
+    __IO uint32_t CPUID, ICSR, VTOR, AIRCR, SCR, CCR;
+    __IO uint8_t  SHP[12];
+    __IO uint32_t SHCSR;
+} SCB_Type;
+extern SCB_Type sim_scb;
+#define SCB                     (&sim_scb)
+#define SCB_ICSR_PENDSVSET_Msk  (1UL << 28)
+
+typedef struct { __IO uint32_t CTRL, CYCCNT; } DWT_Type;
+typedef struct { __IO uint32_t DHCSR, DCRSR, DCRDR, DEMCR; } CoreDebug_Type;
+extern DWT_Type       sim_dwt;
+extern CoreDebug_Type sim_core_debug;
+/* Every DWT access samples the simulated core clock first */
+static inline DWT_Type *sim_dwt_read(void){ sim_dwt.CYCCNT = sim_core_cycles32(); return &sim_dwt; }
+#define DWT                         (sim_dwt_read())
+#define CoreDebug                   (&sim_core_debug)
+#define DWT_CTRL_CYCCNTENA_Msk      1UL
+#define CoreDebug_DEMCR_TRCENA_Msk  (1UL << 24)
+
+/* -------- Peripherals -------- */
+typedef struct {
+    __IO uint32_t MCR;
+    struct { __IO uint32_t LDVAL, CVAL, TCTRL, TFLG; } CHANNEL[4];
+} PIT_Type;
+extern PIT_Type sim_pit;
+#define PIT                     (&sim_pit)
+
+typedef struct { __IO uint32_t SC1[2], CFG1, CFG2, R[2], SC2, SC3; } ADC_Type;
+extern ADC_Type sim_adc[2];
+#define ADC0                    (&sim_adc[0])
+#define ADC1                    (&sim_adc[1])
+
+#define SIM_PORTS               5U      /* PORTA..PORTE, GPIOA..GPIOE */
+typedef struct { __IO uint32_t PCR[32], GPCLR, GPCHR, ISFR; } PORT_Type;
+extern PORT_Type sim_port[SIM_PORTS];
+#define PORTA                   (&sim_port[0])
+#define PORTB                   (&sim_port[1])
+#define PORTC                   (&sim_port[2])
+#define PORTD                   (&sim_port[3])
+#define PORTE                   (&sim_port[4])
+
+typedef struct { __IO uint32_t PDOR, PSOR, PCOR, PTOR, PDIR, PDDR; } GPIO_Type;
+extern GPIO_Type sim_gpio[SIM_PORTS];
+#define GPIOA                   (&sim_gpio[0])
+#define GPIOB                   (&sim_gpio[1])
+#define GPIOC                   (&sim_gpio[2])
+#define GPIOD                   (&sim_gpio[3])
+#define GPIOE                   (&sim_gpio[4])
+
+typedef struct { __IO uint32_t STCTRLH, STCTRLL, TOVAL; } WDOG_Type;
+extern WDOG_Type sim_wdog;
+#define WDOG                        (&sim_wdog)
+#define WDOG_STCTRLH_WDOGEN_MASK    0x1U
+#define WDOG_STCTRLH_IRQRSTEN_MASK  0x4U
+#define WDOG_STCTRLL_INTFLG_MASK    0x8000U
+
+typedef struct { __IO uint8_t SERV, CMPL, CMPH, CTRL; } EWM_Type;
+extern EWM_Type sim_ewm;
+#define EWM                         (&sim_ewm)
+#define EWM_CTRL_EWMEN_MASK         0x1U
+#define EWM_CTRL_INTEN_MASK         0x8U
+
+#endif /* SIM_MK64F12_H_ */
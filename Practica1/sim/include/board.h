@@ -0,0 +1,18 @@
+/**
+ * @file    board.h
+ *
+ * @brief Host simulation stand-in for the FRDM-K64F board header.
+ */
+
+#ifndef SIM_BOARD_H_
+#define SIM_BOARD_H_
+
+#include "fsl_common.h"
+
+#define LOGIC_LED_ON            0U
+#define LED_RED_INIT(output)    ((void)(output))
+#define LED_RED_TOGGLE()        ((void)0)
+
+void BOARD_InitDebugConsole(void);
+
+#endif /* SIM_BOARD_H_ */
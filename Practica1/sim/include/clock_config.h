@@ -0,0 +1,12 @@
+/**
+ * @file    clock_config.h
+ *
+ * @brief Host simulation stand-in for the generated clock configuration header.
+ */
+
+#ifndef SIM_CLOCK_CONFIG_H_
+#define SIM_CLOCK_CONFIG_H_
+
+void BOARD_InitBootClocks(void);
+
+#endif /* SIM_CLOCK_CONFIG_H_ */
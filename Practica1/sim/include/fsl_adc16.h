@@ -0,0 +1,53 @@
+/**
+ * @file    fsl_adc16.h
+ *
+ * @brief Host simulation stand-in for the SDK ADC16 driver.
+ *
+ * A conversion completes immediately; the result follows the waveform installed
+ * with sim_adc_set_source() (sim.h), scaled from 12 bits to the configured resolution.
+ */
+
+#ifndef SIM_FSL_ADC16_H_
+#define SIM_FSL_ADC16_H_
+
+#include "fsl_common.h"
+
+#define FSL_FEATURE_ADC16_HAS_DIFF_MODE 1
+
+typedef enum { kADC16_ClockSourceAlt0 = 0, kADC16_ClockSourceAlt1, kADC16_ClockSourceAlt2,
+               kADC16_ClockSourceAsynchronousClock } adc16_clock_source_t;
+typedef enum { kADC16_ClockDivider1 = 0, kADC16_ClockDivider2, kADC16_ClockDivider4,
+               kADC16_ClockDivider8 } adc16_clock_divider_t;
+typedef enum { kADC16_ResolutionSE8Bit = 0, kADC16_ResolutionSE12Bit, kADC16_ResolutionSE10Bit,
+               kADC16_ResolutionSE16Bit } adc16_resolution_t;
+typedef enum { kADC16_LongSampleCycle24 = 0, kADC16_LongSampleCycle16, kADC16_LongSampleCycle10,
+               kADC16_LongSampleCycle6, kADC16_LongSampleDisabled } adc16_long_sample_mode_t;
+typedef struct {
+    uint32_t referenceVoltageSource;
+    adc16_clock_source_t clockSource;
+    bool enableAsynchronousClock;
+    adc16_clock_divider_t clockDivider;
+    adc16_resolution_t resolution;
+    adc16_long_sample_mode_t longSampleMode;
+    bool enableContinuousConversion;
+} adc16_config_t;
+typedef struct {
+    uint32_t channelNumber;
+    bool     enableInterruptOnConversionCompleted;
+    bool     enableDifferentialConversion;
+} adc16_channel_config_t;
+enum { kADC16_ChannelConversionDoneFlag = 1U };
+typedef enum { kADC16_HardwareAverageCount4 = 0, kADC16_HardwareAverageCount8,
+               kADC16_HardwareAverageCount16, kADC16_HardwareAverageCount32,
+               kADC16_HardwareAverageDisabled } adc16_hardware_average_mode_t;
+
+void     ADC16_GetDefaultConfig(adc16_config_t *config);
+void     ADC16_Init(ADC_Type *base, const adc16_config_t *config);
+void     ADC16_EnableHardwareTrigger(ADC_Type *base, bool enable);
+void     ADC16_EnableDMA(ADC_Type *base, bool enable);
+void     ADC16_SetHardwareAverage(ADC_Type *base, adc16_hardware_average_mode_t mode);
+void     ADC16_SetChannelConfig(ADC_Type *base, uint32_t group, const adc16_channel_config_t *config);
+uint32_t ADC16_GetChannelStatusFlags(ADC_Type *base, uint32_t group);
+uint32_t ADC16_GetChannelConversionValue(ADC_Type *base, uint32_t group);
+
+#endif /* SIM_FSL_ADC16_H_ */
@@ -0,0 +1,30 @@
+/**
+ * @file    fsl_clock.h
+ *
+ * @brief Host simulation stand-in for the SDK clock driver.
+ */
+
+#ifndef SIM_FSL_CLOCK_H_
+#define SIM_FSL_CLOCK_H_
+
+#include <stdint.h>
+
+/* Simulated clock tree: 120 MHz core, 60 MHz bus, 50 MHz OSCERCLK (FRDM-K64F run mode) */
+#define SIM_CORE_CLOCK_HZ   120000000U
+#define SIM_BUS_CLOCK_HZ    60000000U
+#define SIM_OSCER_CLOCK_HZ  50000000U
+
+typedef enum { kCLOCK_CoreSysClk, kCLOCK_BusClk, kCLOCK_Osc0ErClk } clock_name_t;
+/* Gates are not modelled: every peripheral is always clocked */
+typedef enum { kCLOCK_PortA, kCLOCK_PortB, kCLOCK_PortC, kCLOCK_PortD, kCLOCK_PortE } clock_ip_name_t;
+static inline void CLOCK_EnableClock(clock_ip_name_t name){ (void)name; }
+
+static inline uint32_t CLOCK_GetFreq(clock_name_t name){
+    switch (name){
+    case kCLOCK_BusClk:    return SIM_BUS_CLOCK_HZ;
+    case kCLOCK_Osc0ErClk: return SIM_OSCER_CLOCK_HZ;
+    default:               return SIM_CORE_CLOCK_HZ;
+    }
+}
+
+#endif /* SIM_FSL_CLOCK_H_ */
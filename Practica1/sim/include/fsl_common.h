@@ -0,0 +1,23 @@
+/**
+ * @file    fsl_common.h
+ *
+ * @brief Host simulation stand-in for the SDK common header.
+ */
+
+#ifndef SIM_FSL_COMMON_H_
+#define SIM_FSL_COMMON_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "MK64F12.h"
+#include "fsl_clock.h"
+
+typedef int32_t status_t;
+enum { kStatus_Success = 0, kStatus_Fail = 1 };
+
+#define USEC_TO_COUNT(us, clockFreqInHz) (uint64_t)(((uint64_t)(us) * (clockFreqInHz)) / 1000000U)
+#define COUNT_TO_USEC(count, clockFreqInHz) (uint64_t)((uint64_t)(count) * 1000000U / (clockFreqInHz))
+
+#endif /* SIM_FSL_COMMON_H_ */
@@ -0,0 +1,14 @@
+/**
+ * @file    fsl_debug_console.h
+ *
+ * @brief Host simulation stand-in: PRINTF goes to stdout.
+ */
+
+#ifndef SIM_FSL_DEBUG_CONSOLE_H_
+#define SIM_FSL_DEBUG_CONSOLE_H_
+
+#include <stdio.h>
+
+#define PRINTF printf
+
+#endif /* SIM_FSL_DEBUG_CONSOLE_H_ */
@@ -0,0 +1,34 @@
+/**
+ * @file    fsl_ewm.h
+ *
+ * @brief Host simulation stand-in for the SDK EWM driver.
+ *
+ * The counter runs from the simulated LPO (1 kHz, as on the K64) and is restarted by
+ * a refresh. Once it passes compareHighValue EWM_out asserts, and stays asserted until
+ * the next refresh; while it is asserted and the interrupt is enabled,
+ * WDOG_EWM_IRQHandler runs. The refresh window low bound is not modelled.
+ */
+
+#ifndef SIM_FSL_EWM_H_
+#define SIM_FSL_EWM_H_
+
+#include "fsl_common.h"
+
+typedef enum { kEWM_InterruptEnable = EWM_CTRL_INTEN_MASK } ewm_interrupt_enable_t;
+
+typedef struct {
+    bool enableEwm;
+    bool enableEwmInput;
+    bool setInputAssertLogic;
+    bool enableInterrupt;
+    uint8_t compareLowValue;
+    uint8_t compareHighValue;
+} ewm_config_t;
+
+void EWM_GetDefaultConfig(ewm_config_t *config);
+void EWM_Init(EWM_Type *base, const ewm_config_t *config);
+void EWM_Refresh(EWM_Type *base);
+void EWM_EnableInterrupts(EWM_Type *base, uint32_t mask);
+void EWM_DisableInterrupts(EWM_Type *base, uint32_t mask);
+
+#endif /* SIM_FSL_EWM_H_ */
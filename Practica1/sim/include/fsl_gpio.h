@@ -0,0 +1,21 @@
+/**
+ * @file    fsl_gpio.h
+ *
+ * @brief Host simulation stand-in for the SDK GPIO driver.
+ */
+
+#ifndef SIM_FSL_GPIO_H_
+#define SIM_FSL_GPIO_H_
+
+#include "fsl_common.h"
+
+typedef enum { kGPIO_DigitalInput = 0U, kGPIO_DigitalOutput = 1U } gpio_pin_direction_t;
+
+typedef struct {
+    gpio_pin_direction_t pinDirection;
+    uint8_t outputLogic;
+} gpio_pin_config_t;
+
+void GPIO_PinInit(GPIO_Type *base, uint32_t pin, const gpio_pin_config_t *config);
+
+#endif /* SIM_FSL_GPIO_H_ */
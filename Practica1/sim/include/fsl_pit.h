@@ -0,0 +1,30 @@
+/**
+ * @file    fsl_pit.h
+ *
+ * @brief Host simulation stand-in for the SDK PIT driver.
+ *
+ * Channels count down at the simulated bus clock. When a running channel reaches
+ * zero the simulator sets TFLG, reloads LDVAL and calls PITn_IRQHandler.
+ */
+
+#ifndef SIM_FSL_PIT_H_
+#define SIM_FSL_PIT_H_
+
+#include "fsl_common.h"
+
+typedef enum { kPIT_Chnl_0 = 0, kPIT_Chnl_1, kPIT_Chnl_2, kPIT_Chnl_3 } pit_chnl_t;
+typedef enum { kPIT_TimerInterruptEnable = 1U } pit_interrupt_enable_t;
+typedef enum { kPIT_TimerFlag = 1U } pit_status_flags_t;
+typedef struct { bool enableRunInDebug; } pit_config_t;
+
+void     PIT_GetDefaultConfig(pit_config_t *config);
+void     PIT_Init(PIT_Type *base, const pit_config_t *config);
+void     PIT_SetTimerPeriod(PIT_Type *base, pit_chnl_t channel, uint32_t count);
+uint32_t PIT_GetCurrentTimerCount(PIT_Type *base, pit_chnl_t channel);
+void     PIT_EnableInterrupts(PIT_Type *base, pit_chnl_t channel, uint32_t mask);
+uint32_t PIT_GetStatusFlags(PIT_Type *base, pit_chnl_t channel);
+void     PIT_ClearStatusFlags(PIT_Type *base, pit_chnl_t channel, uint32_t mask);
+void     PIT_StartTimer(PIT_Type *base, pit_chnl_t channel);
+void     PIT_StopTimer(PIT_Type *base, pit_chnl_t channel);
+
+#endif /* SIM_FSL_PIT_H_ */
@@ -0,0 +1,43 @@
+/**
+ * @file    fsl_port.h
+ *
+ * @brief Host simulation stand-in for the SDK PORT driver.
+ *
+ * Only the pin interrupt is modelled. A pin configured for falling-edge interrupts
+ * takes its edges from the harness (sim_port_set_source in sim.h); each edge sets
+ * the pin's ISFR flag, and PORTx_IRQHandler runs while any flag of the port is set.
+ */
+
+#ifndef SIM_FSL_PORT_H_
+#define SIM_FSL_PORT_H_
+
+#include "fsl_common.h"
+
+typedef enum { kPORT_PullDisable = 0U, kPORT_PullDown = 2U, kPORT_PullUp = 3U } port_pull_t;
+typedef enum { kPORT_FastSlewRate = 0U, kPORT_SlowSlewRate = 1U } port_slew_rate_t;
+typedef enum { kPORT_PassiveFilterDisable = 0U, kPORT_PassiveFilterEnable = 1U } port_passive_filter_enable_t;
+typedef enum { kPORT_OpenDrainDisable = 0U, kPORT_OpenDrainEnable = 1U } port_open_drain_enable_t;
+typedef enum { kPORT_LowDriveStrength = 0U, kPORT_HighDriveStrength = 1U } port_drive_strength_t;
+typedef enum { kPORT_PinDisabledOrAnalog = 0U, kPORT_MuxAsGpio = 1U } port_mux_t;
+typedef enum { kPORT_UnlockRegister = 0U, kPORT_LockRegister = 1U } port_lock_register_t;
+typedef enum {
+    kPORT_InterruptOrDMADisabled = 0x0U,
+    kPORT_InterruptFallingEdge   = 0xAU
+} port_interrupt_t;
+
+typedef struct {
+    uint16_t pullSelect;
+    uint16_t slewRate;
+    uint16_t passiveFilterEnable;
+    uint16_t openDrainEnable;
+    uint16_t driveStrength;
+    uint16_t mux;
+    uint16_t lockRegister;
+} port_pin_config_t;
+
+void     PORT_SetPinConfig(PORT_Type *base, uint32_t pin, const port_pin_config_t *config);
+void     PORT_SetPinInterruptConfig(PORT_Type *base, uint32_t pin, port_interrupt_t config);
+uint32_t PORT_GetPinsInterruptFlags(PORT_Type *base);
+void     PORT_ClearPinsInterruptFlags(PORT_Type *base, uint32_t mask);
+
+#endif /* SIM_FSL_PORT_H_ */
@@ -0,0 +1,42 @@
+/**
+ * @file    fsl_wdog.h
+ *
+ * @brief Host simulation stand-in for the SDK WDOG driver.
+ *
+ * The watchdog counts simulated LPO milliseconds (1 kHz, prescaler ignored) from its
+ * last refresh. At timeoutValue it sets the timeout flag, which raises
+ * WDOG_EWM_IRQHandler when the interrupt is enabled, and 256 bus clocks later it
+ * resets the MCU: the run stops there (sim_wdog_reset_at in sim.h).
+ */
+
+#ifndef SIM_FSL_WDOG_H_
+#define SIM_FSL_WDOG_H_
+
+#include "fsl_common.h"
+
+typedef enum { kWDOG_LpoClockSource = 0U, kWDOG_AlternateClockSource = 1U } wdog_clock_source_t;
+typedef enum { kWDOG_ClockPrescalerDivide1 = 0U, kWDOG_ClockPrescalerDivide2, kWDOG_ClockPrescalerDivide3,
+               kWDOG_ClockPrescalerDivide4, kWDOG_ClockPrescalerDivide5, kWDOG_ClockPrescalerDivide6,
+               kWDOG_ClockPrescalerDivide7, kWDOG_ClockPrescalerDivide8 } wdog_clock_prescaler_t;
+typedef enum { kWDOG_RunningFlag = WDOG_STCTRLH_WDOGEN_MASK, kWDOG_TimeoutFlag = WDOG_STCTRLL_INTFLG_MASK } wdog_status_flags_t;
+
+typedef struct { bool enableWait; bool enableStop; bool enableDebug; } wdog_work_mode_t;
+typedef struct {
+    bool enableWdog;
+    wdog_clock_source_t clockSource;
+    wdog_clock_prescaler_t prescaler;
+    wdog_work_mode_t workMode;
+    bool enableUpdate;
+    bool enableInterrupt;
+    bool enableWindowMode;
+    uint32_t windowValue;
+    uint32_t timeoutValue;
+} wdog_config_t;
+
+void     WDOG_GetDefaultConfig(wdog_config_t *config);
+void     WDOG_Init(WDOG_Type *base, const wdog_config_t *config);
+void     WDOG_Refresh(WDOG_Type *base);
+uint32_t WDOG_GetStatusFlags(WDOG_Type *base);
+void     WDOG_ClearStatusFlags(WDOG_Type *base, uint32_t mask);
+
+#endif /* SIM_FSL_WDOG_H_ */
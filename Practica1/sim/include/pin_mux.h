@@ -0,0 +1,12 @@
+/**
+ * @file    pin_mux.h
+ *
+ * @brief Host simulation stand-in for the generated pin mux header.
+ */
+
+#ifndef SIM_PIN_MUX_H_
+#define SIM_PIN_MUX_H_
+
+void BOARD_InitBootPins(void);
+
+#endif /* SIM_PIN_MUX_H_ */
@@ -0,0 +1,60 @@
+/**
+ * @file    sim.h
+ *
+ * @brief Host simulation of the K64 peripherals used by Practica1.
+ *
+ * Time is a 64-bit count of simulated 120 MHz core cycles. It only moves when the
+ * harness charges execution time with sim_advance() or the idle loop waits in WFI,
+ * so runs are deterministic. Every PIT expiry, PORT pin edge or WDOG/EWM expiry inside
+ * an advanced interval is delivered at its exact simulated instant, honouring NVIC
+ * priorities, PRIMASK and BASEPRI, which lets interrupts preempt a simulated job part
+ * way through.
+ * Interrupt handlers themselves take no simulated time.
+ */
+
+#ifndef SIM_H_
+#define SIM_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <setjmp.h>
+
+/* Current simulated time (core cycles since reset). */
+uint64_t sim_now(void);
+
+/* Charge `cycles` of execution to the running context, delivering every
+ * interrupt that becomes due on the way. */
+void sim_advance(uint64_t cycles);
+
+/* Deliver pending interrupts allowed by the current masks and priority. */
+void sim_irq_check(void);
+
+/* Host-side cost of the simulated interrupt handlers (nanoseconds) and calls. */
+uint64_t sim_isr_host_ns(void);
+uint64_t sim_isr_calls(void);
+
+/* Stop the run once `done` returns true; checked after every interrupt. The run
+ * unwinds to the setjmp() in `exit_point`. */
+void sim_set_stop(bool (*done)(void), jmp_buf *exit_point);
+
+/* Waveform sampled by ADC16 conversions: counts for the given simulated time. */
+typedef uint16_t (*sim_adc_source_t)(uint32_t converter, uint32_t channel, uint64_t now);
+void sim_adc_set_source(sim_adc_source_t source);
+
+/* Falling edges on a PORT interrupt pin: the instant (core cycles) of the first edge
+ * after `now`, or UINT64_MAX for none. Asked when the pin is configured and again
+ * after every edge; each edge raises PORTx_IRQHandler like a button press. */
+typedef uint64_t (*sim_edge_source_t)(uint32_t port, uint32_t pin, uint64_t now);
+void sim_port_set_source(sim_edge_source_t source);
+
+/* PORT edges delivered so far. */
+uint64_t sim_port_edges(void);
+
+/* Instant (core cycles) at which the WDOG reset the MCU and stopped the run, 0 while
+ * it has not. */
+uint64_t sim_wdog_reset_at(void);
+
+/* Host monotonic clock (nanoseconds), for measuring the code under test. */
+uint64_t sim_host_ns(void);
+
+#endif /* SIM_H_ */
@@ -0,0 +1,74 @@
+/**
+ * @file    sim_adc_bench.c
+ *
+ * @brief Host micro-benchmark of the ADC sample path.
+ *
+ * ADC.c is compiled as part of this translation unit so its static helpers (the
+ * Q16 conversion and the rolling-buffer push) can be timed directly. It is the
+ * only place the sim build compiles ADC.c.
+ */
+
+#include "ADC.c"
+#include "sim.h"
+#include <stdio.h>
+
+/* Keeps the optimizer from discarding results */
+static volatile uint32_t s_sink;
+
+static void sim_bench_report(const char *name, uint64_t ns, uint32_t iterations){
+    printf("  %-28s %7.2f ns/call\n", name, (double)ns / (double)iterations);
+}
+
+void sim_bench_adc(uint32_t iterations){
+    uint64_t start;
+    uint32_t i;
+    uint32_t acc = 0U;
+
+    ADC_InitModule();
+    printf("ADC path, %u iterations\n", (unsigned)iterations);
+
+    start = sim_host_ns();
+    for (i = 0U; i < iterations; i++){
+        acc += ADC_CountsToTempDeci((uint16_t)(i & 0x0FFFU));
+    }
+    s_sink = acc;
+    sim_bench_report("ADC_CountsToTempDeci", sim_host_ns() - start, iterations);
+
+    start = sim_host_ns();
+    for (i = 0U; i < iterations; i++){
+        ADC_PushTemp(&s_chan[0], (uint16_t)(i % (TEMP_MAX_DECI + 1U)));
+    }
+    sim_bench_report("ADC_PushTemp", sim_host_ns() - start, iterations);
+
+    start = sim_host_ns();
+    for (i = 0U; i < iterations; i++){
+        acc += ADC_GetAvgTempDeciC();
+    }
+    s_sink = acc;
+    sim_bench_report("ADC_GetAvgTempDeciC", sim_host_ns() - start, iterations);
+
+    ADC_SetFilter(ADC_FILTER_MEDIAN);
+    start = sim_host_ns();
+    for (i = 0U; i < iterations; i++){
+        acc += ADC_GetFilteredTempDeciC();
+    }
+    s_sink = acc;
+    sim_bench_report("ADC_GetFilteredTempDeciC/med", sim_host_ns() - start, iterations);
+    ADC_SetFilter(ADC_FILTER_MEAN);
+
+    start = sim_host_ns();
+    for (i = 0U; i < iterations; i++){
+        ADC_FormatTempDeciToAscii((uint16_t)(i % (TEMP_MAX_DECI + 1U)));
+        s_sink = gAdcTempAscii[3];
+    }
+    sim_bench_report("ADC_FormatTempDeciToAscii", sim_host_ns() - start, iterations);
+
+    start = sim_host_ns();
+    for (i = 0U; i < iterations; i++){
+        ADC_Service(i * ADC_SAMPLE_PERIOD_MS);
+    }
+    sim_bench_report("ADC_Service (poll+push)", sim_host_ns() - start, iterations);
+
+    /* Leave the module as the firmware would find it */
+    ADC_InitModule();
+}
@@ -0,0 +1,240 @@
+/**
+ * @file    sim_main.c
+ *
+ * @brief Host harness: runs the unmodified RMS scheduler against the simulated
+ *        PIT/NVIC and reports dispatch cost, release jitter and deadline misses.
+ *
+ * Every ThreadTable handler is wrapped before RMS_Main (the firmware main) starts.
+ * The wrapper runs the real handler, then charges a modelled execution time of
+ * ThreadWcetUs scaled by a pseudo-random load in [load_min, load_max] percent, so
+ * overload and deadline-miss policies can be exercised deterministically. Ticks
+ * falling inside a job are delivered at their exact instant, mid-job.
+ *
+ * With RMS_SPORADIC both buttons are pressed at random, every press_us on average
+ * (uniform in [press_us / 2, 3 * press_us / 2]), through the real EVENT.c handlers.
+ * With HEALTH_MONITOR the run stops at a watchdog reset, which is reported.
+ *
+ * Usage: sim_rms [ticks] [load_min_pct] [load_max_pct] [seed] [press_us]
+ */
+
+#include "sim.h"
+#include "RMS.h"
+#include "HEALTH.h"
+#include "NVIC.h"
+#include "ADC.h"
+#include "fsl_common.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#if RMS_PREEMPTIVE
+#error "The host simulation models cooperative dispatch only (no PendSV context switch)"
+#endif
+#if !RMS_STATS
+#error "The host simulation needs RMS_STATS=1 for release and start stamps"
+#endif
+#if NVIC_PROFILE || RMS_TELEMETRY
+#error "The host simulation has no RAM vector table, MSP or RTT channel (NVIC_PROFILE, RMS_TELEMETRY)"
+#endif
+#if ADC_USE_IRQ || ADC_USE_DMA
+#error "The host simulation models ADC polling only"
+#endif
+
+#define SIM_MAX_THREADS         8U
+#define SIM_CYCLES_PER_US       (SIM_CORE_CLOCK_HZ / 1000000U)
+/* Release-to-start latency histogram: 1 us bins up to SIM_HIST_US, plus overflow */
+#define SIM_HIST_US             10000U
+#define SIM_HIST_LOG2_BINS      16U
+
+int  RMS_Main(void);
+void sim_bench_adc(uint32_t iterations);
+
+static void (*s_handler[SIM_MAX_THREADS])(void);
+static uint32_t s_hist[SIM_MAX_THREADS][SIM_HIST_US + 1U];
+static uint64_t s_handlerHostNs = 0U;
+static uint64_t s_jobs = 0U;
+
+static uint32_t s_ticks   = 100000U;
+static uint32_t s_loadMin = 20U;
+static uint32_t s_loadMax = 100U;
+static uint32_t s_rng     = 0x2545F491U;
+static uint32_t s_pressUs = 5000U;
+static jmp_buf  s_exit;
+
+/* xorshift32: same sequence for the same seed on every host */
+static uint32_t sim_random(void){
+    s_rng ^= s_rng << 13;
+    s_rng ^= s_rng >> 17;
+    s_rng ^= s_rng << 5;
+    return s_rng;
+}
+
+static void sim_job(uint8_t index){
+    uint32_t latencyUs = (ThreadStats[index].StartCycle - ThreadStats[index].ReleaseCycle) / SIM_CYCLES_PER_US;
+    uint32_t load = s_loadMin + ((s_loadMax > s_loadMin) ? (sim_random() % (s_loadMax - s_loadMin + 1U)) : 0U);
+    uint64_t start;
+
+    s_hist[index][(latencyUs < SIM_HIST_US) ? latencyUs : SIM_HIST_US]++;
+
+    start = sim_host_ns();
+    s_handler[index]();
+    s_handlerHostNs += sim_host_ns() - start;
+    s_jobs++;
+
+    sim_advance(((uint64_t)ThreadTable[index].ThreadWcetUs * SIM_CYCLES_PER_US * load) / 100U);
+}
+
+#define SIM_JOB(n)  static void sim_job##n(void){ sim_job(n); }
+SIM_JOB(0) SIM_JOB(1) SIM_JOB(2) SIM_JOB(3) SIM_JOB(4) SIM_JOB(5) SIM_JOB(6) SIM_JOB(7)
+static void (*const s_wrapper[SIM_MAX_THREADS])(void) = {
+    sim_job0, sim_job1, sim_job2, sim_job3, sim_job4, sim_job5, sim_job6, sim_job7
+};
+
+/* Without RMS_TICKLESS the firmware idles in a busy loop, entered only once nothing
+ * is ready: skip to the next release instead, or simulated time would never move */
+#if !RMS_TICKLESS && !RMS_HW_RATE_GROUPS
+void RMS_IdleHook(void){
+    sim_wfi();
+}
+#endif
+
+/* Button edges for the sporadic server */
+static uint64_t sim_button_edge(uint32_t port, uint32_t pin, uint64_t now){
+    (void)port;
+    (void)pin;
+    if (s_pressUs == 0U){
+        return UINT64_MAX;
+    }
+    return now + ((uint64_t)(s_pressUs / 2U) + (sim_random() % (s_pressUs + 1U))) * SIM_CYCLES_PER_US;
+}
+
+static bool sim_done(void){
+    return RMS_GetSystemTick() >= s_ticks;
+}
+
+/* Slow triangle over the full 12-bit range (4 s period) with +-8 counts of noise */
+static uint16_t sim_adc_wave(uint32_t converter, uint32_t channel, uint64_t now){
+    uint32_t phase = (uint32_t)((now / SIM_CYCLES_PER_US / 1000U) % 4000U);
+    int32_t counts = (int32_t)((phase < 2000U) ? phase : (4000U - phase)) * 4095 / 2000;
+
+    (void)converter;
+    (void)channel;
+    counts += (int32_t)(sim_random() % 17U) - 8;
+    if (counts < 0) counts = 0;
+    if (counts > 4095) counts = 4095;
+    return (uint16_t)counts;
+}
+
+/* Smallest latency (us) below which `permille` of the thread's jobs started */
+static uint32_t sim_percentile(const uint32_t *hist, uint64_t total, uint32_t permille){
+    uint64_t need = (total * permille + 999U) / 1000U;
+    uint64_t seen = 0U;
+    uint32_t us;
+
+    for (us = 0U; us <= SIM_HIST_US; us++){
+        seen += hist[us];
+        if (seen >= need) break;
+    }
+    return us;
+}
+
+static void sim_report(uint64_t hostNs){
+    uint8_t count = RMS_GetThreadCount();
+    uint64_t simUs = sim_now() / SIM_CYCLES_PER_US;
+    uint64_t isrNs = sim_isr_host_ns();
+    uint64_t calls = sim_isr_calls();
+    uint64_t dispatchNs = hostNs - s_handlerHostNs - isrNs;
+    uint8_t i;
+
+    printf("\n\nSimulated %u ticks (%llu us) in %.1f ms host, load %u..%u%% of WCET\n",
+           (unsigned)RMS_GetSystemTick(), (unsigned long long)simUs, (double)hostNs / 1e6,
+           (unsigned)s_loadMin, (unsigned)s_loadMax);
+    printf("Host cost: tick ISR %.0f ns/call (%llu calls), dispatch+sim %.0f ns/job (%llu jobs)\n",
+           calls ? (double)isrNs / (double)calls : 0.0, (unsigned long long)calls,
+           s_jobs ? (double)dispatchNs / (double)s_jobs : 0.0, (unsigned long long)s_jobs);
+    printf("Throughput: %.2f Mticks/s host\n\n",
+           hostNs ? (double)RMS_GetSystemTick() * 1e3 / (double)hostNs : 0.0);
+#if RMS_SPORADIC
+    printf("Button presses: %llu, every %u us on average\n\n",
+           (unsigned long long)sim_port_edges(), (unsigned)s_pressUs);
+#endif
+
+    printf("thd rate wcet_us     jobs   misses overrun div |  lat_us:  min    avg    p50    p99    max | exec_us:  avg    max\n");
+    for (i = 0U; i < count; i++){
+        const ThdStats *st = &ThreadStats[i];
+        uint64_t total = 0U;
+        uint32_t us;
+
+        for (us = 0U; us <= SIM_HIST_US; us++){
+            total += s_hist[i][us];
+        }
+        printf("%3u %4u %7u %8u %8u %7u %3u | %12u %6u %6u %6u %6u | %13u %6u\n",
+               (unsigned)i, (unsigned)ThreadTable[i].ThreadRate, (unsigned)ThreadTable[i].ThreadWcetUs,
+               (unsigned)st->Jobs, (unsigned)RMS_GetDeadlineMisses(i), (unsigned)st->Overruns,
+               (unsigned)RMS_GetRateDivider(i),
+               (st->Jobs != 0U) ? (unsigned)(st->LatencyMin / SIM_CYCLES_PER_US) : 0U,
+               (unsigned)(RMS_GetAvgLatencyCycles(i) / SIM_CYCLES_PER_US),
+               (unsigned)sim_percentile(s_hist[i], total, 500U),
+               (unsigned)sim_percentile(s_hist[i], total, 990U),
+               (unsigned)(st->LatencyMax / SIM_CYCLES_PER_US),
+               (unsigned)(RMS_GetAvgExecCycles(i) / SIM_CYCLES_PER_US),
+               (unsigned)(st->ExecMax / SIM_CYCLES_PER_US));
+    }
+
+    printf("\nRelease-to-start latency histogram (jobs per bin, bin k = [2^(k-1), 2^k) us)\n");
+    for (i = 0U; i < count; i++){
+        uint32_t bins[SIM_HIST_LOG2_BINS] = {0};
+        uint32_t us, k;
+
+        for (us = 0U; us <= SIM_HIST_US; us++){
+            k = (us == 0U) ? 0U : (32U - (uint32_t)__builtin_clz(us));
+            bins[(k < SIM_HIST_LOG2_BINS) ? k : (SIM_HIST_LOG2_BINS - 1U)] += s_hist[i][us];
+        }
+        printf("thd %u:", (unsigned)i);
+        for (k = 0U; k < SIM_HIST_LOG2_BINS; k++){
+            printf(" %u", (unsigned)bins[k]);
+        }
+        printf("\n");
+    }
+}
+
+int main(int argc, char **argv){
+    uint8_t count = RMS_GetThreadCount();
+    uint64_t start;
+    uint8_t i;
+
+    if (argc > 1) s_ticks   = (uint32_t)strtoul(argv[1], NULL, 0);
+    if (argc > 2) s_loadMin = (uint32_t)strtoul(argv[2], NULL, 0);
+    if (argc > 3) s_loadMax = (uint32_t)strtoul(argv[3], NULL, 0);
+    if (argc > 4) s_rng     = (uint32_t)strtoul(argv[4], NULL, 0) | 1U;
+    if (argc > 5) s_pressUs = (uint32_t)strtoul(argv[5], NULL, 0);
+    if ((count > SIM_MAX_THREADS) || (s_loadMax < s_loadMin)){
+        fprintf(stderr, "sim: unsupported arguments or more than %u threads\n", SIM_MAX_THREADS);
+        return EXIT_FAILURE;
+    }
+
+    sim_adc_set_source(sim_adc_wave);
+    sim_port_set_source(sim_button_edge);
+    sim_bench_adc(1000000U);
+
+    for (i = 0U; i < count; i++){
+        s_handler[i] = ThreadTable[i].ThreadHandler;
+        ThreadTable[i].ThreadHandler = s_wrapper[i];
+    }
+    sim_set_stop(sim_done, &s_exit);
+
+    start = sim_host_ns();
+    if (setjmp(s_exit) == 0){
+        (void)RMS_Main();
+        fprintf(stderr, "sim: scheduler returned\n");
+        return EXIT_FAILURE;
+    }
+    sim_report(sim_host_ns() - start);
+#if HEALTH_MONITOR
+    if (sim_wdog_reset_at() != 0U){
+        printf("WDOG reset at %.3f ms, late threads 0x%08x\n",
+               (double)sim_wdog_reset_at() * 1000.0 / SystemCoreClock, (unsigned)HEALTH_GetUnhealthy());
+        return 3;
+    }
+#endif
+    return (RMS_CheckBudgets() == 0U) ? EXIT_SUCCESS : 2;
+}
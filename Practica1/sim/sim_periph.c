@@ -0,0 +1,589 @@
+/**
+ * @file    sim_periph.c
+ *
+ * @brief Simulated core, NVIC, PIT, PORT, WDOG/EWM and ADC16 for the host build.
+ */
+
+#include "sim.h"
+#include "fsl_common.h"
+#include "fsl_pit.h"
+#include "fsl_adc16.h"
+#include "fsl_port.h"
+#include "fsl_gpio.h"
+#include "fsl_wdog.h"
+#include "fsl_ewm.h"
+#include "board.h"
+#include "pin_mux.h"
+#include "clock_config.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define SIM_PIT_CHANNELS        4U
+#define SIM_PIT_IRQ_BASE        PIT0_IRQn
+#define SIM_PORT_IRQ_BASE       PORTA_IRQn
+/* Timed events: PIT channel expiries, one falling edge per port, EWM_out, WDOG */
+#define SIM_EVENT_EWM           (SIM_PIT_CHANNELS + SIM_PORTS)
+#define SIM_EVENT_WDOG          (SIM_EVENT_EWM + 1U)
+#define SIM_EVENTS              (SIM_EVENT_WDOG + 1U)
+/* Simulated core cycles per LPO (1 kHz) tick, which clocks the WDOG and the EWM */
+#define SIM_CYCLES_PER_LPO      (SIM_CORE_CLOCK_HZ / 1000U)
+/* WDOG timeout interrupt to reset */
+#define SIM_WDOG_RESET_COUNTS   256U
+#define SIM_PCR_IRQC_SHIFT      16U
+#define SIM_PCR_IRQC_MASK       (0xFUL << SIM_PCR_IRQC_SHIFT)
+/* Simulated core cycles per PIT (bus clock) count */
+#define SIM_CYCLES_PER_COUNT    (SIM_CORE_CLOCK_HZ / SIM_BUS_CLOCK_HZ)
+/* Priority of thread mode: below every exception */
+#define SIM_THREAD_PRIORITY     0x100U
+
+/* Handlers come from the code under test; channels it does not use stay empty */
+void PIT0_IRQHandler(void) __attribute__((weak));
+void PIT1_IRQHandler(void) __attribute__((weak));
+void PIT2_IRQHandler(void) __attribute__((weak));
+void PIT3_IRQHandler(void) __attribute__((weak));
+static void (*const s_pitHandler[SIM_PIT_CHANNELS])(void) = {
+    PIT0_IRQHandler, PIT1_IRQHandler, PIT2_IRQHandler, PIT3_IRQHandler
+};
+void PORTA_IRQHandler(void) __attribute__((weak));
+void PORTB_IRQHandler(void) __attribute__((weak));
+void PORTC_IRQHandler(void) __attribute__((weak));
+void PORTD_IRQHandler(void) __attribute__((weak));
+void PORTE_IRQHandler(void) __attribute__((weak));
+static void (*const s_portHandler[SIM_PORTS])(void) = {
+    PORTA_IRQHandler, PORTB_IRQHandler, PORTC_IRQHandler, PORTD_IRQHandler, PORTE_IRQHandler
+};
+void WDOG_EWM_IRQHandler(void) __attribute__((weak));
+
+uint32_t SystemCoreClock = SIM_CORE_CLOCK_HZ;
+uint32_t sim_primask = 0U;
+uint32_t sim_basepri = 0U;
+uint32_t sim_ipsr    = 0U;
+uint8_t  sim_nvic_priority[NUMBER_OF_INT_VECTORS];
+bool     sim_nvic_enabled[NUMBER_OF_INT_VECTORS];
+SCB_Type       sim_scb;
+DWT_Type       sim_dwt;
+CoreDebug_Type sim_core_debug;
+PIT_Type       sim_pit;
+ADC_Type       sim_adc[2];
+PORT_Type      sim_port[SIM_PORTS];
+GPIO_Type      sim_gpio[SIM_PORTS];
+WDOG_Type      sim_wdog;
+EWM_Type       sim_ewm;
+
+static uint64_t s_now = 0U;
+static uint32_t s_runningPriority = SIM_THREAD_PRIORITY;
+
+/* PIT channel model: expiry instant of the running countdown */
+static bool     s_pitRunning[SIM_PIT_CHANNELS];
+static uint64_t s_pitExpiry[SIM_PIT_CHANNELS];
+
+/* PORT model: the pin taking edges from the harness, and its next edge */
+static sim_edge_source_t s_edgeSource = NULL;
+static bool     s_edgeArmed[SIM_PORTS];
+static uint32_t s_edgePin[SIM_PORTS];
+static uint64_t s_edgeAt[SIM_PORTS];
+static uint64_t s_edges = 0U;
+
+/* Watchdogs: next EWM_out assertion and next WDOG event (timeout, then reset) */
+static bool     s_ewmArmed = false;
+static bool     s_ewmAsserted = false;
+static uint64_t s_ewmAt;
+static bool     s_wdogArmed = false;
+static bool     s_wdogTimedOut = false;     /* Reset pending, past the interrupt */
+static uint64_t s_wdogAt;
+static uint64_t s_wdogResetAt = 0U;
+
+static uint64_t s_isrHostNs = 0U;
+static uint64_t s_isrCalls  = 0U;
+
+static bool   (*s_stopDone)(void) = NULL;
+static jmp_buf *s_stopExit = NULL;
+
+static sim_adc_source_t s_adcSource = NULL;
+static uint32_t         s_adcChannel[2];
+static adc16_resolution_t s_adcResolution[2];
+
+/* ================= Time ================= */
+
+uint64_t sim_host_ns(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+uint64_t sim_now(void){
+    return s_now;
+}
+
+uint32_t sim_core_cycles32(void){
+    return (uint32_t)s_now;
+}
+
+uint64_t sim_isr_host_ns(void){
+    return s_isrHostNs;
+}
+
+uint64_t sim_isr_calls(void){
+    return s_isrCalls;
+}
+
+void sim_set_stop(bool (*done)(void), jmp_buf *exit_point){
+    s_stopDone = done;
+    s_stopExit = exit_point;
+}
+
+/* ================= Interrupt delivery ================= */
+
+static bool sim_irq_allowed(uint32_t priority){
+    uint32_t shifted = priority << (8U - __NVIC_PRIO_BITS);
+
+    if (sim_primask != 0U) return false;
+    if ((sim_basepri != 0U) && (shifted >= sim_basepri)) return false;
+    return priority < s_runningPriority;
+}
+
+static void sim_irq_consider(uint32_t vector, int *best, uint32_t *bestPriority){
+    if (sim_nvic_enabled[vector] && (sim_nvic_priority[vector] < *bestPriority)){
+        *best = (int)vector;
+        *bestPriority = sim_nvic_priority[vector];
+    }
+}
+
+/* Highest-priority pending interrupt as a vector number, or -1. PIT interrupts are
+ * level triggered: pending while TFLG and TIE are both set. A PORT interrupt is
+ * pending while any of the port's ISFR flags is, the shared WDOG/EWM one while the
+ * WDOG timeout flag or EWM_out is set with its interrupt enabled. */
+static int sim_irq_pending(void){
+    int best = -1;
+    uint32_t bestPriority = SIM_THREAD_PRIORITY;
+    uint32_t i;
+
+    for (i = 0U; i < SIM_PIT_CHANNELS; i++){
+        if ((sim_pit.CHANNEL[i].TFLG & kPIT_TimerFlag) && (sim_pit.CHANNEL[i].TCTRL & 2U)){
+            sim_irq_consider((uint32_t)SIM_PIT_IRQ_BASE + i + 16U, &best, &bestPriority);
+        }
+    }
+    for (i = 0U; i < SIM_PORTS; i++){
+        if (sim_port[i].ISFR != 0U){
+            sim_irq_consider((uint32_t)SIM_PORT_IRQ_BASE + i + 16U, &best, &bestPriority);
+        }
+    }
+    if (((sim_wdog.STCTRLL & WDOG_STCTRLL_INTFLG_MASK) && (sim_wdog.STCTRLH & WDOG_STCTRLH_IRQRSTEN_MASK)) ||
+        (s_ewmAsserted && (sim_ewm.CTRL & EWM_CTRL_INTEN_MASK))){
+        sim_irq_consider((uint32_t)WDOG_EWM_IRQn + 16U, &best, &bestPriority);
+    }
+    return best;
+}
+
+/* Handler of a vector from sim_irq_pending(). With none, the request is dropped. */
+static void (*sim_irq_handler(uint32_t vector))(void){
+    uint32_t irq = vector - 16U;
+
+    if (irq == (uint32_t)WDOG_EWM_IRQn){
+        if (WDOG_EWM_IRQHandler == NULL){
+            sim_wdog.STCTRLL &= ~WDOG_STCTRLL_INTFLG_MASK;
+            sim_ewm.CTRL &= (uint8_t)~EWM_CTRL_INTEN_MASK;
+        }
+        return WDOG_EWM_IRQHandler;
+    }
+    if (irq >= (uint32_t)SIM_PORT_IRQ_BASE && irq < ((uint32_t)SIM_PORT_IRQ_BASE + SIM_PORTS)){
+        uint32_t port = irq - (uint32_t)SIM_PORT_IRQ_BASE;
+
+        if (s_portHandler[port] == NULL){
+            sim_port[port].ISFR = 0U;
+        }
+        return s_portHandler[port];
+    }
+    if (s_pitHandler[irq - (uint32_t)SIM_PIT_IRQ_BASE] == NULL){
+        sim_pit.CHANNEL[irq - (uint32_t)SIM_PIT_IRQ_BASE].TFLG = 0U;
+    }
+    return s_pitHandler[irq - (uint32_t)SIM_PIT_IRQ_BASE];
+}
+
+void sim_irq_check(void){
+    int vector;
+
+    while ((vector = sim_irq_pending()) >= 0){
+        uint32_t priority = sim_nvic_priority[vector];
+        uint32_t savedPriority = s_runningPriority;
+        uint32_t savedIpsr = sim_ipsr;
+        void (*handler)(void);
+        uint64_t start;
+
+        if (!sim_irq_allowed(priority)){
+            return;
+        }
+        handler = sim_irq_handler((uint32_t)vector);
+        if (handler == NULL){
+            continue;
+        }
+
+        s_runningPriority = priority;
+        sim_ipsr = (uint32_t)vector;
+        start = sim_host_ns();
+        handler();
+        s_isrHostNs += sim_host_ns() - start;
+        s_isrCalls++;
+        sim_ipsr = savedIpsr;
+        s_runningPriority = savedPriority;
+
+        if ((s_stopDone != NULL) && s_stopDone()){
+            longjmp(*s_stopExit, 1);
+        }
+    }
+}
+
+/* Earliest timed event at or before `limit`, or -1: PIT expiries are ids 0..3,
+ * PORT edges SIM_PIT_CHANNELS + port, then SIM_EVENT_EWM and SIM_EVENT_WDOG */
+static int sim_next_event(uint64_t limit){
+    int next = -1;
+    uint64_t nextAt = 0U;
+    uint32_t id;
+
+    for (id = 0U; id < SIM_EVENTS; id++){
+        bool armed;
+        uint64_t at;
+
+        if (id < SIM_PIT_CHANNELS){
+            armed = s_pitRunning[id];
+            at    = s_pitExpiry[id];
+        } else if (id == SIM_EVENT_EWM){
+            armed = s_ewmArmed;
+            at    = s_ewmAt;
+        } else if (id == SIM_EVENT_WDOG){
+            armed = s_wdogArmed;
+            at    = s_wdogAt;
+        } else {
+            armed = s_edgeArmed[id - SIM_PIT_CHANNELS];
+            at    = s_edgeAt[id - SIM_PIT_CHANNELS];
+        }
+        if (armed && (at <= limit) && ((next < 0) || (at < nextAt))){
+            next   = (int)id;
+            nextAt = at;
+        }
+    }
+    return next;
+}
+
+static void sim_pit_expire(uint32_t ch){
+    s_now = s_pitExpiry[ch];
+    sim_pit.CHANNEL[ch].TFLG |= kPIT_TimerFlag;
+    /* Hardware reload from LDVAL, the new countdown starts at the expiry */
+    s_pitExpiry[ch] += ((uint64_t)sim_pit.CHANNEL[ch].LDVAL + 1U) * SIM_CYCLES_PER_COUNT;
+}
+
+/* Ask the harness for the next edge on the port's interrupt pin */
+static void sim_port_arm(uint32_t port){
+    s_edgeAt[port]    = (s_edgeSource != NULL) ? s_edgeSource(port, s_edgePin[port], s_now) : UINT64_MAX;
+    s_edgeArmed[port] = (s_edgeAt[port] != UINT64_MAX);
+}
+
+static void sim_port_edge(uint32_t port){
+    s_now = s_edgeAt[port];
+    sim_port[port].ISFR |= 1UL << s_edgePin[port];
+    s_edges++;
+    sim_port_arm(port);
+}
+
+static void sim_ewm_expire(void){
+    s_now = s_ewmAt;
+    s_ewmArmed    = false;
+    s_ewmAsserted = true;
+}
+
+/* First the timeout flag, then the reset, which ends the run */
+static void sim_wdog_expire(void){
+    s_now = s_wdogAt;
+    if (!s_wdogTimedOut){
+        s_wdogTimedOut = true;
+        sim_wdog.STCTRLL |= WDOG_STCTRLL_INTFLG_MASK;
+        s_wdogAt += (uint64_t)SIM_WDOG_RESET_COUNTS * SIM_CYCLES_PER_COUNT;
+        return;
+    }
+    s_wdogArmed   = false;
+    s_wdogResetAt = s_now;
+    if (s_stopExit == NULL){
+        fprintf(stderr, "sim: WDOG reset\n");
+        exit(EXIT_FAILURE);
+    }
+    longjmp(*s_stopExit, 1);
+}
+
+static void sim_event_fire(int id){
+    if ((uint32_t)id < SIM_PIT_CHANNELS){
+        sim_pit_expire((uint32_t)id);
+    } else if ((uint32_t)id == SIM_EVENT_EWM){
+        sim_ewm_expire();
+    } else if ((uint32_t)id == SIM_EVENT_WDOG){
+        sim_wdog_expire();
+    } else {
+        sim_port_edge((uint32_t)id - SIM_PIT_CHANNELS);
+    }
+}
+
+void sim_advance(uint64_t cycles){
+    uint64_t target = s_now + cycles;
+    int id;
+
+    while ((id = sim_next_event(target)) >= 0){
+        sim_event_fire(id);
+        sim_irq_check();
+    }
+    s_now = target;
+}
+
+/* WFI: jump to the next timed event and wake; the ISR runs once the masks allow it */
+void sim_wfi(void){
+    int id = sim_next_event(UINT64_MAX);
+
+    if (id < 0){
+        fprintf(stderr, "sim: WFI with no timer running, nothing can wake the core\n");
+        exit(EXIT_FAILURE);
+    }
+    sim_event_fire(id);
+    sim_irq_check();
+}
+
+/* ================= PIT driver ================= */
+
+void PIT_GetDefaultConfig(pit_config_t *config){
+    config->enableRunInDebug = false;
+}
+
+void PIT_Init(PIT_Type *base, const pit_config_t *config){
+    (void)config;
+    memset((void *)base, 0, sizeof(*base));
+    memset(s_pitRunning, 0, sizeof(s_pitRunning));
+}
+
+void PIT_SetTimerPeriod(PIT_Type *base, pit_chnl_t channel, uint32_t count){
+    /* Like LDVAL on the K64: a running channel picks it up at its next reload */
+    base->CHANNEL[channel].LDVAL = count - 1U;
+}
+
+uint32_t PIT_GetCurrentTimerCount(PIT_Type *base, pit_chnl_t channel){
+    uint64_t left;
+
+    if (!s_pitRunning[channel]){
+        return base->CHANNEL[channel].LDVAL;
+    }
+    left = (s_pitExpiry[channel] - s_now) / SIM_CYCLES_PER_COUNT;
+    return (left > 0U) ? (uint32_t)(left - 1U) : 0U;
+}
+
+void PIT_EnableInterrupts(PIT_Type *base, pit_chnl_t channel, uint32_t mask){
+    if (mask & kPIT_TimerInterruptEnable){
+        base->CHANNEL[channel].TCTRL |= 2U;    /* TIE */
+    }
+}
+
+uint32_t PIT_GetStatusFlags(PIT_Type *base, pit_chnl_t channel){
+    return base->CHANNEL[channel].TFLG;
+}
+
+void PIT_ClearStatusFlags(PIT_Type *base, pit_chnl_t channel, uint32_t mask){
+    base->CHANNEL[channel].TFLG &= ~mask;
+}
+
+void PIT_StartTimer(PIT_Type *base, pit_chnl_t channel){
+    base->CHANNEL[channel].TCTRL |= 1U;        /* TEN */
+    s_pitRunning[channel] = true;
+    s_pitExpiry[channel]  = s_now + ((uint64_t)base->CHANNEL[channel].LDVAL + 1U) * SIM_CYCLES_PER_COUNT;
+}
+
+void PIT_StopTimer(PIT_Type *base, pit_chnl_t channel){
+    base->CHANNEL[channel].TCTRL &= ~1U;
+    s_pitRunning[channel] = false;
+}
+
+/* ================= PORT and GPIO drivers ================= */
+
+void sim_port_set_source(sim_edge_source_t source){
+    s_edgeSource = source;
+}
+
+uint64_t sim_port_edges(void){
+    return s_edges;
+}
+
+static uint32_t sim_port_index(const PORT_Type *base){
+    return (uint32_t)(base - sim_port);
+}
+
+void PORT_SetPinConfig(PORT_Type *base, uint32_t pin, const port_pin_config_t *config){
+    base->PCR[pin] = (base->PCR[pin] & SIM_PCR_IRQC_MASK) | ((uint32_t)config->mux << 8);
+}
+
+void PORT_SetPinInterruptConfig(PORT_Type *base, uint32_t pin, port_interrupt_t config){
+    uint32_t port = sim_port_index(base);
+
+    base->PCR[pin] = (base->PCR[pin] & ~SIM_PCR_IRQC_MASK) | ((uint32_t)config << SIM_PCR_IRQC_SHIFT);
+    if (config == kPORT_InterruptFallingEdge){
+        s_edgePin[port] = pin;
+        sim_port_arm(port);
+    } else if (s_edgePin[port] == pin){
+        s_edgeArmed[port] = false;
+    }
+}
+
+uint32_t PORT_GetPinsInterruptFlags(PORT_Type *base){
+    return base->ISFR;
+}
+
+void PORT_ClearPinsInterruptFlags(PORT_Type *base, uint32_t mask){
+    base->ISFR &= ~mask;
+}
+
+void GPIO_PinInit(GPIO_Type *base, uint32_t pin, const gpio_pin_config_t *config){
+    if (config->pinDirection == kGPIO_DigitalOutput){
+        base->PDDR |= 1UL << pin;
+    } else {
+        base->PDDR &= ~(1UL << pin);
+    }
+}
+
+/* ================= WDOG and EWM drivers ================= */
+
+uint64_t sim_wdog_reset_at(void){
+    return s_wdogResetAt;
+}
+
+void WDOG_GetDefaultConfig(wdog_config_t *config){
+    memset(config, 0, sizeof(*config));
+    config->enableWdog   = true;
+    config->clockSource  = kWDOG_LpoClockSource;
+    config->enableUpdate = true;
+    config->timeoutValue = 0xFFFFU;
+}
+
+void WDOG_Init(WDOG_Type *base, const wdog_config_t *config){
+    base->STCTRLH  = (config->enableWdog ? WDOG_STCTRLH_WDOGEN_MASK : 0U) |
+                     (config->enableInterrupt ? WDOG_STCTRLH_IRQRSTEN_MASK : 0U);
+    base->STCTRLL  = 0U;
+    base->TOVAL    = config->timeoutValue;
+    s_wdogArmed    = config->enableWdog;
+    s_wdogTimedOut = false;
+    WDOG_Refresh(base);
+}
+
+/* A refresh after the timeout cannot hold off the reset any more */
+void WDOG_Refresh(WDOG_Type *base){
+    if (s_wdogArmed && !s_wdogTimedOut){
+        s_wdogAt = s_now + ((uint64_t)base->TOVAL * SIM_CYCLES_PER_LPO);
+    }
+}
+
+uint32_t WDOG_GetStatusFlags(WDOG_Type *base){
+    return (base->STCTRLH & WDOG_STCTRLH_WDOGEN_MASK) | (base->STCTRLL & WDOG_STCTRLL_INTFLG_MASK);
+}
+
+void WDOG_ClearStatusFlags(WDOG_Type *base, uint32_t mask){
+    base->STCTRLL &= ~(mask & WDOG_STCTRLL_INTFLG_MASK);
+}
+
+void EWM_GetDefaultConfig(ewm_config_t *config){
+    memset(config, 0, sizeof(*config));
+    config->enableEwm        = true;
+    config->compareHighValue = 0xFEU;
+}
+
+void EWM_Init(EWM_Type *base, const ewm_config_t *config){
+    base->CMPL = config->compareLowValue;
+    base->CMPH = config->compareHighValue;
+    base->CTRL = (uint8_t)((config->enableEwm ? EWM_CTRL_EWMEN_MASK : 0U) |
+                           (config->enableInterrupt ? EWM_CTRL_INTEN_MASK : 0U));
+    EWM_Refresh(base);
+}
+
+void EWM_Refresh(EWM_Type *base){
+    s_ewmAsserted = false;
+    s_ewmArmed    = (base->CTRL & EWM_CTRL_EWMEN_MASK) != 0U;
+    s_ewmAt       = s_now + (((uint64_t)base->CMPH + 1U) * SIM_CYCLES_PER_LPO);
+}
+
+void EWM_EnableInterrupts(EWM_Type *base, uint32_t mask){
+    base->CTRL |= (uint8_t)(mask & EWM_CTRL_INTEN_MASK);
+    sim_irq_check();
+}
+
+void EWM_DisableInterrupts(EWM_Type *base, uint32_t mask){
+    base->CTRL &= (uint8_t)~(mask & EWM_CTRL_INTEN_MASK);
+}
+
+/* ================= ADC16 driver ================= */
+
+void sim_adc_set_source(sim_adc_source_t source){
+    s_adcSource = source;
+}
+
+static uint32_t sim_adc_index(const ADC_Type *base){
+    return (base == ADC0) ? 0U : 1U;
+}
+
+void ADC16_GetDefaultConfig(adc16_config_t *config){
+    memset(config, 0, sizeof(*config));
+    config->clockSource    = kADC16_ClockSourceAsynchronousClock;
+    config->enableAsynchronousClock = true;
+    config->clockDivider   = kADC16_ClockDivider8;
+    config->resolution     = kADC16_ResolutionSE12Bit;
+    config->longSampleMode = kADC16_LongSampleDisabled;
+}
+
+void ADC16_Init(ADC_Type *base, const adc16_config_t *config){
+    memset((void *)base, 0, sizeof(*base));
+    s_adcResolution[sim_adc_index(base)] = config->resolution;
+}
+
+void ADC16_EnableHardwareTrigger(ADC_Type *base, bool enable){
+    (void)base;
+    (void)enable;
+}
+
+void ADC16_EnableDMA(ADC_Type *base, bool enable){
+    (void)base;
+    (void)enable;
+}
+
+void ADC16_SetHardwareAverage(ADC_Type *base, adc16_hardware_average_mode_t mode){
+    (void)base;
+    (void)mode;
+}
+
+/* The conversion completes at once: R[group] holds the result, COCO set */
+void ADC16_SetChannelConfig(ADC_Type *base, uint32_t group, const adc16_channel_config_t *config){
+    uint32_t index = sim_adc_index(base);
+    uint16_t counts;
+
+    s_adcChannel[index] = config->channelNumber;
+    counts = (s_adcSource != NULL) ? s_adcSource(index, config->channelNumber, s_now) : 0U;
+    counts &= 0x0FFFU;
+    switch (s_adcResolution[index]){
+    case kADC16_ResolutionSE8Bit:  counts >>= 4; break;
+    case kADC16_ResolutionSE10Bit: counts >>= 2; break;
+    case kADC16_ResolutionSE16Bit: counts <<= 4; break;
+    default: break;
+    }
+    base->R[group]   = counts;
+    base->SC1[group] = 0x80U;                  /* COCO */
+}
+
+uint32_t ADC16_GetChannelStatusFlags(ADC_Type *base, uint32_t group){
+    return (base->SC1[group] & 0x80U) ? kADC16_ChannelConversionDoneFlag : 0U;
+}
+
+uint32_t ADC16_GetChannelConversionValue(ADC_Type *base, uint32_t group){
+    base->SC1[group] &= ~0x80U;
+    return base->R[group];
+}
+
+/* ================= Board ================= */
+
+void BOARD_InitBootPins(void){
+}
+
+void BOARD_InitBootClocks(void){
+}
+
+void BOARD_InitDebugConsole(void){
+}